@@ -19,22 +19,50 @@
 #ifndef ANTARES_DATA_SNDFILE_HPP_
 #define ANTARES_DATA_SNDFILE_HPP_
 
+#include <memory>
 #include <pn/data>
 
 namespace antares {
 
+// 16-bit signed LPCM, in native byte order. Sounds that were decoded by build-plugin are read in
+// place from the bundle, and leave `data` empty; others are decoded into `data`.
 struct SoundData {
-    pn::data data;  // 16-bit signed LPCM
-    int      channels;
-    int      frequency;
+    pn::data      data;
+    pn::data_view in_place;
+    int           channels;
+    int           frequency;
+
+    pn::data_view samples() const { return data.size() ? pn::data_view{data} : in_place; }
+};
+
+// Decodes audio a piece at a time, as it plays, so that a whole song needn't be held in memory.
+class SoundStream {
+  public:
+    SoundStream() {}
+    SoundStream(const SoundStream&) = delete;
+    SoundStream& operator=(const SoundStream&) = delete;
+
+    virtual ~SoundStream() {}
+
+    virtual int channels() const  = 0;
+    virtual int frequency() const = 0;
+
+    // Decodes up to `size` bytes of 16-bit signed LPCM into `data`, and returns the number of
+    // bytes decoded. Only whole frames are decoded; 0 is returned at the end of the stream.
+    virtual int read(uint8_t* data, int size) = 0;
+
+    // Returns to the start of the stream.
+    virtual void rewind() = 0;
 };
 
 namespace sndfile {
-SoundData convert(pn::data_view in);
+SoundData                    convert(pn::data_view in);
+std::unique_ptr<SoundStream> stream(pn::data in);
 }  // namespace sndfile
 
 namespace modplug {
-SoundData convert(pn::data_view in);
+SoundData                    convert(pn::data_view in);
+std::unique_ptr<SoundStream> stream(pn::data in);
 }  // namespace modplug
 
 }  // namespace antares
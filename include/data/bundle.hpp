@@ -0,0 +1,104 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2008-2017 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#ifndef ANTARES_DATA_BUNDLE_HPP_
+#define ANTARES_DATA_BUNDLE_HPP_
+
+#include <map>
+#include <pn/data>
+#include <pn/output>
+#include <pn/string>
+#include <sfz/sfz.hpp>
+#include <vector>
+
+#include "data/audio.hpp"
+#include "drawing/pix-map.hpp"
+
+namespace antares {
+
+// A plugin compiled by build-plugin into a single uncompressed file. The file is mapped into
+// memory, and resources are read from it in place.
+//
+// All integers are big-endian:
+//   magic     8 bytes, "antares\x01"
+//   count     uint32
+//   entries   `count` times: uint32 path size, path, uint64 offset, uint64 size
+//   contents  each entry's contents, at its offset from the start of the file
+//
+// An entry's size must fit in an int, because that's the size of a pn::data_view.
+//
+// build-plugin decodes sprites and sounds, so that loading them from a bundle needs no PNG or
+// audio decoding. "sprites/{name}/image.png" is stored as "sprites/{name}/image.pix" (likewise
+// "overlay"), and "sounds/{name}.aiff" (or .s3m, .xm) as "sounds/{name}.pcm":
+//   pix       uint32 width, uint32 height, then each pixel as four bytes: alpha, red, green, blue
+//   pcm       uint32 channels, uint32 frequency, then 16-bit signed little-endian samples
+// Both are laid out as they are in memory (on little-endian hosts, for pcm), so they can be read
+// in place. Music is streamed as it plays, so it stays encoded.
+class PluginBundle {
+  public:
+    struct Entry {
+        pn::string_view path;
+        pn::data_view   data;
+    };
+
+    // Reads only the file's magic number.
+    static bool is_bundle(pn::string_view path);
+
+    // Throws if any part of the bundle can't be written, and removes the incomplete file.
+    static void write(pn::string_view path, const std::map<pn::string, pn::data>& files);
+
+    explicit PluginBundle(pn::string_view path);
+    PluginBundle(const PluginBundle&) = delete;
+    PluginBundle& operator=(const PluginBundle&) = delete;
+
+    pn::string_view           path() const { return _path; }
+    const std::vector<Entry>& entries() const { return _entries; }
+
+  private:
+    pn::string         _path;
+    sfz::mapped_file   _file;
+    std::vector<Entry> _entries;
+};
+
+// The pixels of a decoded sprite, read in place from the data it was made from, which must
+// outlive it. It's read-only: mutable_bytes() throws.
+class MappedPixMap : public PixMap {
+  public:
+    // Throws if `in` is too short for the size in its header.
+    explicit MappedPixMap(pn::data_view in);
+
+    virtual const Size&     size() const;
+    virtual const RgbColor* bytes() const;
+    virtual int             row_bytes() const;
+    virtual RgbColor*       mutable_bytes();
+
+  private:
+    Size            _size;
+    const RgbColor* _bytes;
+};
+
+// read_pcm() returns samples in place, in `in_place`, on little-endian hosts; `in` must outlive
+// them. Big-endian hosts get a swapped copy, in `data`.
+void         write_pix(pn::output_view out, const PixMap& pix);
+MappedPixMap read_pix(pn::data_view in);
+void         write_pcm(pn::output_view out, const SoundData& sound);
+SoundData    read_pcm(pn::data_view in);
+
+}  // namespace antares
+
+#endif  // ANTARES_DATA_BUNDLE_HPP_
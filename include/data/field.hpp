@@ -19,6 +19,7 @@
 #ifndef ANTARES_DATA_FIELD_HPP_
 #define ANTARES_DATA_FIELD_HPP_
 
+#include <initializer_list>
 #include <pn/fwd>
 #include <pn/string>
 #include <pn/value>
@@ -215,8 +216,23 @@ struct field {
             : set([field](T* t, path_value x) { (t->*field) = read_field<F>(x); }) {}
 };
 
+// The fields of a struct, in the order they're read. A list rather than a map, because it's
+// built on every call, and a map would allocate a node for each field.
 template <typename T>
-T required_struct(path_value x, const std::map<pn::string_view, field<T>>& fields) {
+using field_list = std::initializer_list<std::pair<pn::string_view, field<T>>>;
+
+template <typename T>
+bool has_field(field_list<T> fields, pn::string_view key) {
+    for (const auto& kv : fields) {
+        if (kv.first == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T>
+T required_struct(path_value x, field_list<T> fields) {
     if (x.value().is_map()) {
         T t;
         for (const auto& kv : fields) {
@@ -225,9 +241,9 @@ T required_struct(path_value x, const std::map<pn::string_view, field<T>>& field
         }
         for (auto kv : x.value().as_map()) {
             pn::string_view k = kv.key();
-            path_value      v = x.get(k);
-            if (fields.find(k) == fields.end()) {
-                throw std::runtime_error(pn::format("{0}unknown field", v.prefix()).c_str());
+            if (!has_field(fields, k)) {
+                throw std::runtime_error(
+                        pn::format("{0}unknown field", x.get(k).prefix()).c_str());
             }
         }
         return t;
@@ -239,7 +255,7 @@ T required_struct(path_value x, const std::map<pn::string_view, field<T>>& field
 }
 
 template <typename T>
-sfz::optional<T> optional_struct(path_value x, const std::map<pn::string_view, field<T>>& fields) {
+sfz::optional<T> optional_struct(path_value x, field_list<T> fields) {
     if (x.value().is_null()) {
         return sfz::nullopt;
     } else if (x.value().is_map()) {
@@ -19,6 +19,7 @@
 #ifndef ANTARES_DATA_PLUGIN_HPP_
 #define ANTARES_DATA_PLUGIN_HPP_
 
+#include <stdint.h>
 #include <map>
 #include <sfz/sfz.hpp>
 #include <vector>
@@ -34,18 +35,38 @@ class ZipArchive;
 namespace antares {
 
 class BaseObject;
+class PluginBundle;
 union Level;
 struct Race;
 
+// Objects and races persist across levels, so that starting a level only parses those that are
+// new, or whose files have changed since they were parsed. `loaded` is set for those that the
+// current level has loaded; the rest are kept only as a cache, and can't be gotten.
+template <typename T>
+struct Loaded {
+    T                       value;
+    std::vector<pn::string> sources;  // Files that `value` was parsed from.
+    uint64_t                digest;   // Of the contents of `sources`.
+    bool                    loaded;
+};
+
+// Levels are cataloged by PluginInit(), which finds only their chapters. Each is parsed the
+// first time it's gotten.
+struct CatalogedLevel {
+    sfz::optional<int64_t> chapter;
+    std::unique_ptr<Level> level;  // Null until parsed.
+};
+
 struct ScenarioGlobals {
     sfz::optional<pn::string>          dir;
     std::unique_ptr<zipxx::ZipArchive> zip;
+    std::unique_ptr<PluginBundle>      bundle;
 
-    Info                             info;
-    std::map<int, pn::string>        chapters;
-    std::map<pn::string, Level>      levels;
-    std::map<pn::string, BaseObject> objects;
-    std::map<pn::string, Race>       races;
+    Info                                     info;
+    std::map<int, pn::string>                chapters;
+    std::map<pn::string, CatalogedLevel>     levels;
+    std::map<pn::string, Loaded<BaseObject>> objects;
+    std::map<pn::string, Loaded<Race>>       races;
 
     Texture splash;
     Texture starmap;
@@ -57,6 +78,8 @@ void PluginInit(sfz::optional<pn::string_view> path);
 
 void load_race(const NamedHandle<const Race>& r);
 void load_object(const NamedHandle<const BaseObject>& o);
+void unload_races();
+void unload_objects();
 
 }  // namespace antares
 
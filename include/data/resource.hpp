@@ -20,14 +20,16 @@
 #define ANTARES_DATA_RESOURCE_HPP_
 
 #include <stdint.h>
+#include <memory>
 #include <pn/string>
+#include <sfz/sfz.hpp>
 #include <vector>
 
 namespace antares {
 
-class ArrayPixMap;
 class BaseObject;
 class NatePixTable;
+class PixMap;
 class Texture;
 struct Info;
 struct InterfaceData;
@@ -36,31 +38,52 @@ union Level;
 struct Race;
 struct ReplayData;
 struct SoundData;
+class SoundStream;
 struct SpriteData;
 
 class Resource {
   public:
+    // Paths of the files that a resource was read from, relative to the plugin root.
+    using Sources = std::vector<pn::string>;
+
     static std::vector<pn::string> list_levels();
+    static std::vector<pn::string> list_objects();
+    static std::vector<pn::string> list_races();
     static std::vector<pn::string> list_replays();
     static bool                    object_exists(pn::string_view name);
+    static uint64_t                digest(const Sources& sources);
+
+    // Templates resolved by object() are memoized, and resolved again only if their sources'
+    // digest changes. PluginInit() clears them, since they may come from the previous plugin.
+    static void clear_templates();
+
+    // Finds every resource in the plugin, factory scenario, and application data. Lookups
+    // consult only what was found, so this must be called again if any of them change.
+    static void reindex();
+
+    // Whether resources can be read from several threads at once. They can't be when the plugin
+    // is a zip file, because its archive is shared.
+    static bool thread_safe();
 
-    static FontData                font(pn::string_view name);
-    static Texture                 font_image(pn::string_view name);
-    static Info                    info();
-    static InterfaceData           interface(pn::string_view name);
-    static Level                   level(pn::string_view path);
-    static SoundData               music(pn::string_view name);
-    static BaseObject              object(pn::string_view path);
-    static Race                    race(pn::string_view path);
-    static ReplayData              replay(pn::string_view name);
-    static std::vector<int32_t>    rotation_table();
-    static SoundData               sound(pn::string_view name);
-    static SpriteData              sprite_data(pn::string_view name);
-    static ArrayPixMap             sprite_image(pn::string_view name);
-    static ArrayPixMap             sprite_overlay(pn::string_view name);
-    static std::vector<pn::string> strings(pn::string_view name);
-    static pn::string              text(pn::string_view name);
-    static Texture                 texture(pn::string_view name);
+    static FontData                     font(pn::string_view name);
+    static Texture                      font_image(pn::string_view name);
+    static Info                         info();
+    static InterfaceData                interface(pn::string_view name);
+    static Level                        level(pn::string_view path);
+    static sfz::optional<int64_t>       level_chapter(pn::string_view path);
+    static SoundData                    music(pn::string_view name);
+    static std::unique_ptr<SoundStream> music_stream(pn::string_view name);
+    static BaseObject                   object(pn::string_view path, Sources* sources = nullptr);
+    static Race                         race(pn::string_view path, Sources* sources = nullptr);
+    static ReplayData                   replay(pn::string_view name);
+    static std::vector<int32_t>         rotation_table();
+    static SoundData                    sound(pn::string_view name);
+    static SpriteData                   sprite_data(pn::string_view name);
+    static std::unique_ptr<PixMap>      sprite_image(pn::string_view name);
+    static std::unique_ptr<PixMap>      sprite_overlay(pn::string_view name);
+    static std::vector<pn::string>      strings(pn::string_view name);
+    static pn::string                   text(pn::string_view name);
+    static Texture                      texture(pn::string_view name);
 
     Resource() = delete;
 };
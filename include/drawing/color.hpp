@@ -64,6 +64,13 @@ class RgbColor {
 
     static RgbColor tint(Hue hue, uint8_t shade);
 
+    // In each of red, green, and blue, tint(hue, shade) is (diffuse * shade + ambient) / 256.
+    struct TintCoefficients {
+        int diffuse[3];
+        int ambient[3];
+    };
+    static TintCoefficients tint_coefficients(Hue hue);
+
     static const RgbColor& at(uint8_t index);
 
     uint8_t alpha;
@@ -0,0 +1,48 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2008-2017 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#ifndef ANTARES_DRAWING_PIX_KERNELS_HPP_
+#define ANTARES_DRAWING_PIX_KERNELS_HPP_
+
+#include "drawing/color.hpp"
+
+namespace antares {
+
+// Row-at-a-time loops behind PixMap and NatePixTable. The SCALAR kernels define the results;
+// the others must match them exactly, pixel for pixel.
+//
+// The best kernels that the CPU supports are chosen at startup. Others can be selected for
+// testing, if the CPU supports them.
+enum class PixKernels { SCALAR, SSE2, AVX2 };
+bool       pix_kernels_supported(PixKernels kernels);
+PixKernels pix_kernels();
+void       set_pix_kernels(PixKernels kernels);
+
+// Sets each of the `width` pixels in `row` to `color`.
+void fill_row(RgbColor* row, RgbColor color, int width);
+
+// Draws `over` onto `under`, as PixMap::composite() does.
+void composite_row(RgbColor* under, const RgbColor* over, int width);
+
+// Draws `overlay` onto `image`, tinted with `hue`. The red channel of each overlay pixel gives
+// the shade of the tint, and its alpha gives the tint's opacity. The image keeps its alpha.
+void tint_row(RgbColor* image, const RgbColor* overlay, Hue hue, int width);
+
+}  // namespace antares
+
+#endif  // ANTARES_DRAWING_PIX_KERNELS_HPP_
@@ -195,6 +195,14 @@ class ArrayPixMap : public PixMap {
 
 // Deserializes an ArrayPixMap from its serialized PNG form.
 ArrayPixMap read_png(pn::input_view in);
+ArrayPixMap read_png(pn::data_view png);
+
+// Returns the size of the image in `png`, from its header, without decoding it.
+Size png_size(pn::data_view png);
+
+// Decodes `png` directly into `pix`, which must already have the image's size. `pix` may be a
+// view into a larger PixMap, such as an atlas; only its rows are written.
+void read_png(pn::data_view png, PixMap& pix);
 
 inline void swap(ArrayPixMap& x, ArrayPixMap& y) { x.swap(y); }
 
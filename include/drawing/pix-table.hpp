@@ -19,6 +19,7 @@
 #ifndef ANTARES_DRAWING_PIX_TABLE_HPP_
 #define ANTARES_DRAWING_PIX_TABLE_HPP_
 
+#include <memory>
 #include <vector>
 
 #include "drawing/pix-map.hpp"
@@ -30,6 +31,13 @@ class NatePixTable {
   public:
     class Frame;
 
+    // How frames are tinted for hues other than GRAY. PRECOMPOSITED tints each frame's overlay
+    // into its image when loading it, so every hue has its own textures. SHADER uploads the image
+    // and overlay once, and tables of every hue share them; the overlay is tinted when drawn.
+    enum class Tinting { PRECOMPOSITED, SHADER };
+    static void    set_tinting(Tinting tinting);
+    static Tinting tinting();
+
     NatePixTable(pn::string_view name, Hue hue);
     NatePixTable(const NatePixTable&) = delete;
     NatePixTable(NatePixTable&&)      = default;
@@ -37,19 +45,31 @@ class NatePixTable {
     NatePixTable& operator=(NatePixTable&&) = default;
     ~NatePixTable();
 
+    // Reads and tints the frames, without creating their textures, so that it can be called
+    // off the main thread. upload() must be called before the table is drawn.
+    static NatePixTable decode(pn::string_view name, Hue hue);
+    void                upload();
+
+    // Returns a table which shares this one's frames, but tints them with `hue`. This table must
+    // have been uploaded with Tinting::SHADER.
+    NatePixTable hued(Hue hue) const;
+
     const Frame& at(size_t index) const;
     size_t       size() const;
 
   private:
+    NatePixTable() = default;
+
     size_t             _size;
+    pn::string         _name;
     std::vector<Frame> _frames;
 };
 
 class NatePixTable::Frame {
   public:
-    Frame(Rect bounds, const PixMap& image, pn::string_view name, int frame);
-    Frame(Rect bounds, const PixMap& image, pn::string_view name, int frame, const PixMap& overlay,
-          Hue hue);
+    Frame(Rect bounds, const PixMap& image);
+    Frame(Rect bounds, const PixMap& image, const PixMap& overlay, Hue hue);
+    Frame(const Frame& base, Hue hue);
     Frame(Frame&&) = default;
     ~Frame();
 
@@ -57,17 +77,20 @@ class NatePixTable::Frame {
     uint16_t       height() const;
     Size           size() const { return Size{width(), height()}; };
     Point          center() const;
-    const PixMap&  pix_map() const;
+    const PixMap&  pix_map() const;  // Without the overlay, if it's tinted when drawn.
     const Texture& texture() const;
 
+    void build(pn::string_view name, int frame);
+
   private:
     void load_image(const PixMap& pix);
     void load_overlay(const PixMap& pix, Hue hue);
-    void build(pn::string_view name, int frame);
 
-    Rect        _bounds;
-    ArrayPixMap _pix_map;
-    Texture     _texture;
+    Rect                         _bounds;
+    std::shared_ptr<ArrayPixMap> _pix_map;
+    std::shared_ptr<ArrayPixMap> _overlay;  // Only if tinted when drawn.
+    Hue                          _hue = Hue::GRAY;
+    Texture                      _texture;
 };
 
 }  // namespace antares
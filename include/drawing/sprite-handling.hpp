@@ -19,12 +19,15 @@
 #ifndef ANTARES_DRAWING_SPRITE_HANDLING_HPP_
 #define ANTARES_DRAWING_SPRITE_HANDLING_HPP_
 
+#include <deque>
+#include <future>
 #include <map>
 
 #include "data/base-object.hpp"
 #include "data/handle.hpp"
 #include "drawing/color.hpp"
 #include "drawing/pix-table.hpp"
+#include "lang/work-queue.hpp"
 #include "math/fixed.hpp"
 #include "math/scale.hpp"
 
@@ -87,9 +90,25 @@ class Pix {
     NatePixTable*       get(pn::string_view id, Hue hue);
     const NatePixTable* cursor();
 
+    // Like add(), but decodes the table on a worker thread. It can't be gotten until upload()
+    // has finished it.
+    void request(pn::string_view id, Hue hue);
+
+    // Waits for the earliest requested table to finish decoding, then uploads it, along with
+    // any later ones that are also ready. Returns the number still decoding.
+    int upload();
+    int requested() const { return _requested; }  // Since reset().
+
   private:
-    std::map<std::pair<pn::string, Hue>, NatePixTable> _pix;
-    std::unique_ptr<NatePixTable>                      _cursor;
+    using Key      = std::pair<pn::string, Hue>;
+    using Decoding = std::map<Key, std::future<NatePixTable>>;
+
+    std::map<Key, NatePixTable>    _pix;
+    Decoding                       _decoding;
+    std::deque<Decoding::iterator> _order;  // In which tables were requested.
+    int                            _requested = 0;
+    std::unique_ptr<NatePixTable>  _cursor;
+    WorkQueue                      _work;  // Last, so that its jobs finish first.
 };
 
 void           SpriteHandlingInit();
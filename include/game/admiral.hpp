@@ -19,6 +19,8 @@
 #ifndef ANTARES_GAME_ADMIRAL_HPP_
 #define ANTARES_GAME_ADMIRAL_HPP_
 
+#include <map>
+
 #include "data/base-object.hpp"
 #include "data/enums.hpp"
 #include "data/handle.hpp"
@@ -93,6 +95,12 @@ struct admiralBuildType {
 
 class Admiral {
   public:
+    // How computer admirals choose destinations for their ships. INCREMENTAL considers one
+    // (ship, destination) pair per think(), and is needed to reproduce replays. BATCHED
+    // reconsiders a few ships per think(), against all destinations at once.
+    enum class Scoring { INCREMENTAL, BATCHED };
+    static void set_scoring(Scoring scoring);
+
     static void                init();
     static void                reset();
     static Admiral*            get(int i);
@@ -107,6 +115,12 @@ class Admiral {
     void pay_absolute(Cash howMuch);
     void remove_destination(Handle<Destination> d);
 
+    // Index of objects owned by this admiral which are not kObjectAvailable.
+    void                add_object(Handle<SpaceObject> o);
+    void                remove_object(Handle<SpaceObject> o);
+    Handle<SpaceObject> objects() const { return _objects; }
+    int32_t             object_count(const BaseObject* base) const;
+
     Handle<SpaceObject> control() const;
     Handle<SpaceObject> target() const;
     void                set_control(Handle<SpaceObject> object);
@@ -183,10 +197,17 @@ class Admiral {
     uint32_t                       _cheats = 0;
     pn::string                     _name;
 
+    Handle<SpaceObject>                  _objects;  // Head of LL of owned objs.
+    int32_t                              _object_count = 0;
+    std::map<const BaseObject*, int32_t> _base_counts;
+
   private:
     Admiral() = default;
 
+    void think_incremental();
+    void think_batched();
     void think_build();
+    void decide(Handle<SpaceObject> ship);
 };
 
 void ResetAllDestObjectData();
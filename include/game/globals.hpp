@@ -19,6 +19,7 @@
 #ifndef ANTARES_GAME_GLOBALS_HPP_
 #define ANTARES_GAME_GLOBALS_HPP_
 
+#include <map>
 #include <queue>
 
 #include "config/keys.hpp"
@@ -81,6 +82,9 @@ struct GlobalState {
     Handle<SpaceObject>            ship;     // Local player's flagship.
     Handle<SpaceObject>            root;     // Head of LL of active objs, in creation time order.
 
+    int32_t                              object_count;  // Objects not kObjectAvailable.
+    std::map<const BaseObject*, int32_t> base_counts;   // Ditto, by base type.
+
     std::unique_ptr<Vector[]>      vectors;       // Auxiliary info for kIsVector objects.
     std::unique_ptr<Destination[]> destinations;  // Auxiliary info for kIsDestination objects.
     std::unique_ptr<Sprite[]>      sprites;       // Auxiliary info for objects with sprites.
@@ -33,9 +33,10 @@ namespace antares {
 union Level;
 
 struct LoadState {
-    bool    done = false;
-    int32_t step = 0;
-    int32_t max  = 1;  // So that (step / max) is 0 before construct_level() starts.
+    bool    done     = false;
+    int32_t step     = 0;
+    int32_t max      = 1;    // So that (step / max) is 0 before construct_level() starts.
+    double  fraction = 0.0;  // Of the current step, if it takes several calls.
 };
 
 LoadState start_construct_level(const Level& level);
@@ -19,7 +19,11 @@
 #ifndef ANTARES_GAME_MOTION_HPP_
 #define ANTARES_GAME_MOTION_HPP_
 
+#include <sfz/sfz.hpp>
+#include <vector>
+
 #include "data/base-object.hpp"
+#include "data/handle.hpp"
 #include "math/scale.hpp"
 #include "math/units.hpp"
 
@@ -37,6 +41,45 @@ void ResetMotionGlobals();
 void MoveSpaceObjects(ticks unitsToDo);
 void CollideSpaceObjects();
 
+// How CollideSpaceObjects() sets localFriendStrength and localFoeStrength. PAIRWISE accumulates
+// strength between every pair of objects in adjacent far-grid cells, and is required to match
+// replays. INFLUENCE_MAP sums strength by owner into a grid in one pass, and gives each object
+// the sums from the cells around it, which is linear in the number of objects but approximate.
+enum class Locality { PAIRWISE, INFLUENCE_MAP };
+void set_locality(Locality locality);
+
+// Accuracy of INFLUENCE_MAP relative to PAIRWISE. While a report is set, PAIRWISE values are
+// used regardless of set_locality(), and INFLUENCE_MAP values are computed alongside them for
+// comparison only.
+struct LocalityReport {
+    int64_t samples      = 0;  // objects compared, summed over all ticks
+    int64_t exact        = 0;  // ...of which both values matched exactly
+    double  friend_total = 0;  // sum of |PAIRWISE friend strength|
+    double  friend_error = 0;  // sum of |INFLUENCE_MAP - PAIRWISE| friend strength
+    double  foe_total    = 0;
+    double  foe_error    = 0;
+};
+void set_locality_report(LocalityReport* report);
+
+// Range queries over objects that are not kObjectAvailable, by location. They are backed by a
+// grid like the one used for locality, which is rebuilt on demand after objects move or are
+// added or removed.
+//
+// objects_in_rect() and objects_in_radius() return objects in order of number, the same order
+// as a scan over SpaceObject::all(). nearest_objects() returns objects in order of distance,
+// with ties broken by number.
+struct SpaceObjectFilter {
+    uint32_t                       attributes = 0;  // If nonzero, match any one of these.
+    sfz::optional<Handle<Admiral>> owner;           // If set, match only this owner.
+    Handle<SpaceObject>            exclude;         // Never matched.
+};
+std::vector<Handle<SpaceObject>> objects_in_rect(Rect r, const SpaceObjectFilter& filter);
+std::vector<Handle<SpaceObject>> objects_in_radius(
+        Point center, int32_t radius, const SpaceObjectFilter& filter);
+std::vector<Handle<SpaceObject>> nearest_objects(
+        Point center, int count, const SpaceObjectFilter& filter);
+void invalidate_object_grid();
+
 }  // namespace antares
 
 #endif  // ANTARES_GAME_MOTION_HPP_
@@ -138,6 +138,8 @@ class SpaceObject {
     Handle<SpaceObject> nextFarObject;
     Handle<SpaceObject> previousObject;
     Handle<SpaceObject> nextObject;
+    Handle<SpaceObject> previousOwnedObject;  // LL of objs with the same owner, if any.
+    Handle<SpaceObject> nextOwnedObject;
 
     int32_t runTimeFlags        = 0;       // distance from origin to destination
     Point   destinationLocation = {0, 0};  // coords of our destination ( or kNoDestination)
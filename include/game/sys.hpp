@@ -48,9 +48,6 @@ struct SystemGlobals {
     std::vector<pn::string> gamepad_names;
     std::vector<pn::string> gamepad_long_names;
 
-    enum { ROT_TABLE_SIZE = 720 };
-    std::vector<int32_t> rot_table;
-
     SoundDriver* audio = nullptr;
     VideoDriver* video = nullptr;
     PrefsDriver* prefs = nullptr;
@@ -0,0 +1,88 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2008-2017 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#ifndef ANTARES_GAME_TARGET_SCORING_HPP_
+#define ANTARES_GAME_TARGET_SCORING_HPP_
+
+#include <stdint.h>
+#include <vector>
+
+#include "math/fixed.hpp"
+
+namespace antares {
+
+// What a computer admiral considers about one of its ships, when choosing where to send it.
+struct ScoringShip {
+    int32_t  owner;
+    uint32_t order_flags;  // from its BaseObject
+    int32_t  escort_class;
+    bool     guarding;    // on guard duty
+    bool     free;        // on guard duty, or no duty at all
+    bool     blitzkrieg;  // its admiral is in a blitzkrieg
+    int32_t  h, v;
+};
+
+// What a computer admiral considers about a possible destination. The local strengths are taken
+// from the object that stands for the destination’s distance grid, and are from the point of
+// view of `local_owner`.
+struct ScoringTarget {
+    int32_t owner;  // -1 if none
+    bool    is_destination;
+    int32_t escort_class;
+    Fixed   escort_strength;
+    Fixed   escort_need;
+    int32_t h, v;
+    int32_t local_owner;
+    Fixed   local_friend_strength;
+    Fixed   local_foe_strength;
+};
+
+// How much `ship` wants to go to `target`, before randomization. `prefers` and `forced` say
+// whether `target` matches the tags that `ship` prefers and requires; they are only consulted
+// if its order flags ask for them.
+Fixed target_value(
+        const ScoringShip& ship, const ScoringTarget& target, bool prefers, bool forced);
+
+// Many targets, stored as parallel arrays, so that they can be scored against a ship at once.
+class ScoringTargets {
+  public:
+    void   clear();
+    void   push_back(const ScoringTarget& target);
+    size_t size() const { return _owner.size(); }
+
+    // Sets values[i] to target_value(ship, target i, prefers[i], forced[i]), for every target.
+    // The loops have no branches, so that the compiler can vectorize them.
+    void score(
+            const ScoringShip& ship, const int32_t* prefers, const int32_t* forced,
+            Fixed* values) const;
+
+  private:
+    enum { kDestination = 1 << 0, kNeedsEscort = 1 << 1 };
+
+    std::vector<int32_t> _owner;
+    std::vector<int32_t> _kind;
+    std::vector<int32_t> _escort_class;
+    std::vector<int32_t> _h, _v;
+    std::vector<int32_t> _local_owner;
+    std::vector<int32_t> _local_friend_strength;
+    std::vector<int32_t> _local_foe_strength;
+};
+
+}  // namespace antares
+
+#endif  // ANTARES_GAME_TARGET_SCORING_HPP_
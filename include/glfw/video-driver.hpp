@@ -55,6 +55,13 @@ class GLFWVideoDriver : public OpenGlVideoDriver {
 
     void loop(Card* initial);
 
+    // Shows each frame as soon as it's drawn, without waiting for the display's vertical
+    // refresh. Otherwise, the swap interval is left at the platform's default.
+    void set_no_vsync(bool no_vsync) { _no_vsync = no_vsync; }
+
+    // On leaving loop(), prints frame times and CPU usage to stderr.
+    void set_frame_stats(bool frame_stats) { _frame_stats = frame_stats; }
+
   private:
     void        key(int key, int scancode, int action, int mods);
     void        char_(unsigned int code_point);
@@ -69,6 +76,7 @@ class GLFWVideoDriver : public OpenGlVideoDriver {
     static void mouse_move_callback(GLFWwindow* w, double x, double y);
     static void window_size_callback(GLFWwindow* w, int width, int height);
     static void window_maximize_callback(GLFWwindow* w, int maximized);
+    static void window_refresh_callback(GLFWwindow* w);
 
     bool            _fullscreen;
     Size            _screen_size;
@@ -79,6 +87,9 @@ class GLFWVideoDriver : public OpenGlVideoDriver {
     wall_time       _last_click_usecs;
     int             _last_click_count;
     TextReceiver*   _text;
+    bool            _dirty       = true;
+    bool            _no_vsync    = false;
+    bool            _frame_stats = false;
 };
 
 }  // namespace antares
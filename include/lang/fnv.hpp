@@ -0,0 +1,54 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2008-2017 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#ifndef ANTARES_LANG_FNV_HPP_
+#define ANTARES_LANG_FNV_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <pn/data>
+#include <pn/string>
+
+namespace antares {
+
+// 64-bit FNV-1a. Each call continues from `h`, so that data can be hashed a piece at a time.
+const uint64_t kFnvBasis = 0xcbf29ce484222325ull;
+const uint64_t kFnvPrime = 0x100000001b3ull;
+
+inline uint64_t fnv(uint64_t h, const uint8_t* data, int size) {
+    for (int i = 0; i < size; ++i) {
+        h = (h ^ data[i]) * kFnvPrime;
+    }
+    return h;
+}
+
+inline uint64_t fnv(uint64_t h, pn::data_view data) { return fnv(h, data.data(), data.size()); }
+
+inline uint64_t fnv(uint64_t h, pn::string_view s) {
+    return fnv(h, reinterpret_cast<const uint8_t*>(s.data()), s.size());
+}
+
+// For unordered containers keyed by strings.
+struct FnvHash {
+    size_t operator()(pn::string_view s) const { return fnv(kFnvBasis, s); }
+};
+
+}  // namespace antares
+
+#endif  // ANTARES_LANG_FNV_HPP_
@@ -0,0 +1,54 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2018 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#ifndef ANTARES_LANG_WORK_QUEUE_HPP_
+#define ANTARES_LANG_WORK_QUEUE_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace antares {
+
+// Runs jobs on a fixed set of worker threads, which are started by the first post(). Jobs are
+// started in the order they're posted, but may finish in any order.
+class WorkQueue {
+  public:
+    WorkQueue();
+    WorkQueue(const WorkQueue&) = delete;
+    WorkQueue& operator=(const WorkQueue&) = delete;
+    ~WorkQueue();  // Waits for queued jobs to finish.
+
+    void post(std::function<void()> job);
+
+  private:
+    void work();
+
+    std::mutex                        _mutex;
+    std::condition_variable           _ready;
+    std::deque<std::function<void()>> _jobs;
+    bool                              _stopping;
+    std::vector<std::thread>          _threads;
+};
+
+}  // namespace antares
+
+#endif  // ANTARES_LANG_WORK_QUEUE_HPP_
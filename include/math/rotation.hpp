@@ -31,6 +31,8 @@ enum {
     ROT_90  = 90,
     ROT_180 = 180,
     ROT_POS = 360,
+
+    ROT_TABLE_SIZE = ROT_POS * 2,
 };
 
 // mAngleDifference: get the smallest difference from theta to other
@@ -64,7 +66,15 @@ inline void mAddAngle(T& theta, int32_t other) {
     }
 }
 
-void    GetRotPoint(Fixed* x, Fixed* y, int32_t rotpos);
+// (h, v) for each angle. Generated at build time from data/rotation-table by
+// scripts/generate-rotation-table.py; rotation-test checks it against Resource::rotation_table().
+extern const int32_t rot_table[ROT_TABLE_SIZE];
+
+inline void GetRotPoint(Fixed* x, Fixed* y, int32_t rotpos) {
+    *x = Fixed::from_val(rot_table[rotpos * 2]);
+    *y = Fixed::from_val(rot_table[(rotpos * 2) + 1]);
+}
+
 int32_t GetAngleFromVector(int32_t x, int32_t y);
 
 }  // namespace antares
@@ -23,6 +23,8 @@
 #include <pn/output>
 #include <pn/string>
 
+#include "data/audio.hpp"
+
 namespace antares {
 
 class Sound {
@@ -62,6 +64,13 @@ class SoundDriver {
     virtual std::unique_ptr<Sound>        open_music(pn::string_view path)  = 0;
     virtual void                          set_global_volume(uint8_t volume) = 0;
 
+    // Drivers that play sounds can open them from data that was decoded separately, so that
+    // decoding can happen on other threads. Others ignore the data, and needn't be given any.
+    virtual bool                   decodes_sounds() const { return false; }
+    virtual std::unique_ptr<Sound> open_decoded_sound(pn::string_view path, SoundData data) {
+        return open_sound(path);
+    }
+
     static SoundDriver* driver();
 };
 
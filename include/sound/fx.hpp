@@ -21,18 +21,37 @@
 
 #include <stdint.h>
 
+#include <deque>
+#include <future>
+#include <memory>
+#include <pn/string>
+#include <unordered_map>
 #include <vector>
 
+#include "data/audio.hpp"
 #include "data/handle.hpp"
+#include "lang/fnv.hpp"
+#include "lang/work-queue.hpp"
 #include "math/fixed.hpp"
 #include "math/units.hpp"
 
 namespace antares {
 
+class Sound;
+
 const int32_t kMaxVolumePreference = 8;
 
 class SoundFX {
   public:
+    // How sounds are assigned to the driver's channels. CHANNELS has three channels, and a new
+    // sound takes over the first channel that plays the same sound, a quieter one, or a lower-
+    // priority one, in that order. VOICES tracks up to 32 voices, each until its persistence
+    // runs out, and plays one on a channel only if it ranks among the top 8 by priority, then
+    // loudness, then recency. Both are deterministic. The mode is read by init().
+    enum class Mixing { CHANNELS, VOICES };
+    static void   set_mixing(Mixing mixing);
+    static Mixing mixing();
+
     SoundFX();
     ~SoundFX();
 
@@ -42,6 +61,15 @@ class SoundFX {
     void reset();
     void stop();
 
+    // Like load(), but decodes the sound on a worker thread, if the driver plays sounds. It
+    // can't be played until upload() has opened it.
+    void request(pn::string_view id);
+
+    // Waits for the earliest requested sound to finish decoding, then opens it, along with any
+    // later ones that are also ready. Returns the number still decoding.
+    int upload();
+    int requested() const { return num_requested; }  // Since reset().
+
     void play(pn::string_view id, uint8_t volume, usecs persistence, uint8_t priority);
     void play_at(
             pn::string_view id, int32_t volume, usecs persistence, uint8_t priority,
@@ -67,19 +95,35 @@ class SoundFX {
     void cloak_off_at(Handle<SpaceObject> object);
 
   private:
-    struct smartSoundHandle;
     struct smartSoundChannel;
+    struct Voice;
+    int  intern(pn::string_view id);
+    void play_sound(int sound, uint8_t amplitude, usecs persistence, uint8_t priority);
 
-    bool same_sound_channel(int& channel, pn::string_view id, uint8_t amplitude, uint8_t priority);
+    bool same_sound_channel(int& channel, int sound, uint8_t amplitude, uint8_t priority);
     bool quieter_channel(int& channel, uint8_t amplitude);
     bool lower_priority_channel(int& channel, uint8_t priority);
     bool oldest_available_channel(int& channel);
     bool best_channel(
-            int& channel, pn::string_view sound_id, uint8_t amplitude, usecs persistence,
-            uint8_t priority);
-
-    std::vector<smartSoundHandle>  sounds;
-    std::vector<smartSoundChannel> channels;
+            int& channel, int sound, uint8_t amplitude, usecs persistence, uint8_t priority);
+
+    static bool outranks(const Voice& x, const Voice& y);
+    Voice*      voice_for(int sound, uint8_t amplitude, uint8_t priority);
+    void        realize(Voice& voice);
+    void        release(Voice& voice);
+
+    // Each sound ID that has been loaded, in the order it was interned. `sound_ids` refers to the
+    // strings in `sound_names`, which is a deque so that they don't move.
+    std::deque<pn::string>                            sound_names;
+    std::unordered_map<pn::string_view, int, FnvHash> sound_ids;
+    std::vector<std::unique_ptr<Sound>>               sounds;  // By interned ID; null if unloaded.
+    std::vector<smartSoundChannel>                    channels;
+    std::vector<Voice>                                voices;
+    int64_t                                           next_voice;
+
+    std::deque<std::pair<int, std::future<SoundData>>> decoding;  // In request order.
+    int                                                num_requested = 0;
+    WorkQueue                                          work;  // Last, so its jobs finish first.
 };
 
 }  // namespace antares
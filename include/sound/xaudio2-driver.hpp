@@ -40,6 +40,8 @@ class XAudio2SoundDriver : public SoundDriver {
     virtual std::unique_ptr<Sound>        open_sound(pn::string_view path);
     virtual std::unique_ptr<Sound>        open_music(pn::string_view path);
     virtual void                          set_global_volume(uint8_t volume);
+    virtual bool                          decodes_sounds() const { return true; }
+    virtual std::unique_ptr<Sound>        open_decoded_sound(pn::string_view path, SoundData data);
 
     uint32_t alloc_operation_set();
 
@@ -39,11 +39,23 @@ class EventScheduler {
         virtual Card* top() const                = 0;
     };
 
+    // Virtual time jumps straight to the next event, timer, or snapshot, so a run costs one
+    // iteration per piece of work, not one per tick. `ticks` against `iterations` shows how
+    // much time was skipped.
+    struct Counters {
+        int64_t iterations = 0;
+        int64_t events     = 0;
+        int64_t timers     = 0;
+        int64_t snapshots  = 0;
+        int64_t ticks      = 0;
+    };
+
     EventScheduler();
     EventScheduler(const EventScheduler&) = delete;
     EventScheduler& operator=(const EventScheduler&) = delete;
 
     void schedule_snapshot(int64_t at);
+    void schedule_snapshots(int64_t start, int64_t interval, int64_t end);  // [start, end), once
     void schedule_event(std::unique_ptr<Event> event);
     void schedule_key(Key key, int64_t down, int64_t up);
     void schedule_mouse(int button, const Point& where, int64_t down, int64_t up);
@@ -54,16 +66,25 @@ class EventScheduler {
     InputMode input_mode() const { return KEYBOARD_MOUSE; }
     wall_time now() const { return wall_time(_ticks); }
 
+    const Counters& counters() const { return _counters; }
+
   private:
-    void advance_tick_count(MainLoop& loop, wall_ticks ticks);
-    bool have_snapshots_before(wall_ticks ticks) const;
+    void       advance_tick_count(MainLoop& loop, wall_ticks ticks);
+    bool       have_snapshots_before(wall_ticks ticks) const;
+    bool       have_recurring_snapshot() const;
+    wall_ticks next_snapshot() const;
+    void       pop_snapshots(wall_ticks at);
 
     static bool is_later(const std::unique_ptr<Event>& x, const std::unique_ptr<Event>& y);
 
     wall_ticks                          _ticks;
     std::vector<wall_ticks>             _snapshot_times;
+    wall_ticks                          _recurring_next;
+    ticks                               _recurring_interval{0};
+    wall_ticks                          _recurring_end;
     std::vector<std::unique_ptr<Event>> _event_heap;
     Point                               _mouse;
+    Counters                            _counters;
 };
 
 }  // namespace antares
@@ -54,6 +54,13 @@ class VideoDriver {
     virtual wall_time now() const = 0;
 
     virtual Texture texture(pn::string_view name, const PixMap& content, int scale) = 0;
+
+    // Creates a texture whose `overlay` is tinted when it is drawn, rather than when it is
+    // loaded. The red channel of `overlay` gives the shade of the tint, and its alpha gives the
+    // tint's opacity. The texture draws untinted until copied by Texture::hued().
+    virtual Texture texture(
+            pn::string_view name, const PixMap& content, const PixMap& overlay, int scale) = 0;
+
     virtual void    dither_rect(const Rect& rect, const RgbColor& color)            = 0;
     virtual void    draw_triangle(const Rect& rect, const RgbColor& color)          = 0;
     virtual void    draw_diamond(const Rect& rect, const RgbColor& color)           = 0;
@@ -97,6 +104,10 @@ class Texture {
                 const RgbColor& fill_color) const = 0;
         virtual const Size& size() const          = 0;
 
+        // Returns a texture sharing this one's image and overlay, with the overlay tinted by
+        // `hue`. Only textures created with an overlay can be hued.
+        virtual std::unique_ptr<Impl> hued(Hue hue) const;
+
         virtual void begin_quads() const {}
         virtual void end_quads() const {}
         virtual void draw_quad(const Rect& dest, const Rect& source, const RgbColor& tint) const {
@@ -145,6 +156,8 @@ class Texture {
 
     const Size& size() const { return _impl->size(); }
 
+    Texture hued(Hue hue) const { return _impl->hued(hue); }
+
   private:
     friend class Quads;
 
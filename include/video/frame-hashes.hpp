@@ -0,0 +1,76 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2008-2017 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#ifndef ANTARES_VIDEO_FRAME_HASHES_HPP_
+#define ANTARES_VIDEO_FRAME_HASHES_HPP_
+
+#include <stdint.h>
+
+#include <deque>
+#include <map>
+#include <pn/data>
+#include <pn/string>
+#include <sfz/sfz.hpp>
+
+namespace antares {
+
+class PixMap;
+
+// Hashes the contents of a snapshot: the pixels of an image, or the bytes of a text log.
+uint64_t frame_hash(const PixMap& pix);
+uint64_t frame_hash(pn::data_view data);
+uint64_t frame_hash(pn::string_view text);
+
+// Checks snapshots against golden ones by their hashes, so that only snapshots which differ need
+// to be written out in full. The hash of every snapshot is recorded in a manifest, one line per
+// snapshot, in the order they were taken:
+//
+//     screens/000900.png 2b1f6ac4e8d07a53
+//
+// The golden snapshots may be given as such a manifest, or as a directory of snapshots, which are
+// read and hashed as they're needed. A snapshot that isn't in the golden set never matches.
+class FrameHashes {
+  public:
+    struct Frame {
+        pn::string relpath;
+        uint64_t   hash;
+    };
+
+    FrameHashes(pn::string_view golden);
+    FrameHashes(const FrameHashes&) = delete;
+    FrameHashes& operator=(const FrameHashes&) = delete;
+
+    // Adds a snapshot to the manifest. Its hash is set by match(), which may be called from
+    // another thread, once for each frame.
+    Frame* add(pn::string_view relpath);
+    bool   match(Frame* frame, uint64_t hash);
+
+    void save(pn::string_view path) const;
+
+  private:
+    sfz::optional<uint64_t> golden_hash(pn::string_view relpath) const;
+
+    const pn::string                    _golden;
+    pn::string                          _manifest;
+    std::map<pn::string_view, uint64_t> _manifest_hashes;  // Views into _manifest.
+    std::deque<Frame>                   _frames;           // So that Frame* stays valid.
+};
+
+}  // namespace antares
+
+#endif  // ANTARES_VIDEO_FRAME_HASHES_HPP_
@@ -56,6 +56,14 @@ class OffscreenVideoDriver : public OpenGlVideoDriver {
     void capture(std::vector<std::pair<std::unique_ptr<Card>, pn::string>>& pix);
     void set_capture_rect(Rect r) { _capture_rect = r; }
 
+    // Streams snapshots to `path` (or stdout, if "-") as YUV4MPEG2 video, instead of writing
+    // them to the output directory. Snapshots should be taken every `ticks_per_frame` ticks.
+    void set_video_out(pn::string_view path, int ticks_per_frame);
+
+    // Records snapshots by hash, in `frames.hash` in the output directory, and only writes out
+    // those that don't match the ones in `golden` (see FrameHashes).
+    void set_hash_frames(pn::string_view golden) { _hash_frames.emplace(golden.copy()); }
+
   private:
     const Size                _screen_size;
     const int                 _scale;
@@ -63,6 +71,9 @@ class OffscreenVideoDriver : public OpenGlVideoDriver {
     const pn::string          _glsl_version;
     sfz::optional<pn::string> _output_dir;
     Rect                      _capture_rect;
+    sfz::optional<pn::string> _video_out;
+    int                       _ticks_per_frame = 1;
+    sfz::optional<pn::string> _hash_frames;
 
     EventScheduler* _scheduler = nullptr;
 };
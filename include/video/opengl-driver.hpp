@@ -58,6 +58,8 @@ class OpenGlVideoDriver : public VideoDriver {
     virtual int scale() const;
 
     virtual Texture texture(pn::string_view name, const PixMap& content, int scale);
+    virtual Texture texture(
+            pn::string_view name, const PixMap& content, const PixMap& overlay, int scale);
     virtual void    dither_rect(const Rect& rect, const RgbColor& color);
     virtual void    draw_point(const Point& at, const RgbColor& color);
     virtual void    draw_line(const Point& from, const Point& to, const RgbColor& color);
@@ -77,6 +79,10 @@ class OpenGlVideoDriver : public VideoDriver {
         Uniform<vec2>          unit            = {"unit"};
         Uniform<vec4>          outline_color   = {"outline_color"};
         Uniform<int>           seed            = {"seed"};
+        Uniform<sampler2DRect> overlay         = {"overlay"};
+        Uniform<sampler2D>     tint_table      = {"tint_table"};
+        Uniform<int>           tinted          = {"tinted"};
+        Uniform<int>           tint_hue        = {"tint_hue"};
     };
 
   protected:
@@ -43,6 +43,8 @@ class TextVideoDriver : public VideoDriver {
     virtual wall_time now() const { return _scheduler->now(); }
 
     virtual Texture texture(pn::string_view name, const PixMap& content, int scale);
+    virtual Texture texture(
+            pn::string_view name, const PixMap& content, const PixMap& overlay, int scale);
     virtual void    dither_rect(const Rect& rect, const RgbColor& color);
     virtual void    draw_triangle(const Rect& rect, const RgbColor& color);
     virtual void    draw_diamond(const Rect& rect, const RgbColor& color);
@@ -51,6 +53,13 @@ class TextVideoDriver : public VideoDriver {
     void loop(Card* initial, EventScheduler& scheduler);
     void capture(std::vector<std::pair<std::unique_ptr<Card>, pn::string>>& pix);
 
+    // Records snapshots by hash, in `frames.hash` in the output directory, and only writes out
+    // those that don't match the ones in `golden` (see FrameHashes).
+    void set_hash_frames(pn::string_view golden) { _hash_frames.emplace(golden.copy()); }
+
+    // Compresses snapshots with gzip, adding `.gz` to their names.
+    void set_gzip(bool gzip) { _gzip = gzip; }
+
   private:
     class MainLoop;
     class TextureImpl;
@@ -68,6 +77,8 @@ class TextVideoDriver : public VideoDriver {
 
     const Size                _size;
     sfz::optional<pn::string> _output_dir;
+    sfz::optional<pn::string> _hash_frames;
+    bool                      _gzip = false;
 
     pn::string                             _log;
     std::vector<std::pair<size_t, size_t>> _last_args;
@@ -0,0 +1,42 @@
+#!/usr/bin/env python3
+# Copyright (C) 2018 The Antares Authors
+# This file is part of Antares, a tactical space combat game.
+# Antares is free software, distributed under the LGPL+. See COPYING.
+
+# Converts data/rotation-table, 360 big-endian (h, v) pairs of Fixed values, into a C++ source
+# file defining antares::rot_table, so that it needn't be loaded at startup.
+
+import argparse
+import struct
+
+ROT_TABLE_SIZE = 720
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("input")
+    parser.add_argument("--out", required=True)
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+    if len(data) != ROT_TABLE_SIZE * 4:
+        raise SystemExit(
+            "%s: expected %d bytes, got %d" % (args.input, ROT_TABLE_SIZE * 4, len(data))
+        )
+    values = struct.unpack(">%di" % ROT_TABLE_SIZE, data)
+
+    with open(args.out, "w") as out:
+        out.write("// Generated by scripts/generate-rotation-table.py. Do not edit.\n\n")
+        out.write('#include "math/rotation.hpp"\n\n')
+        out.write("namespace antares {\n\n")
+        out.write("constexpr int32_t rot_table[ROT_TABLE_SIZE] = {\n")
+        for angle in range(ROT_TABLE_SIZE // 2):
+            h, v = values[angle * 2], values[angle * 2 + 1]
+            out.write("        %d, %d,  // %d\n" % (h, v, angle))
+        out.write("};\n\n")
+        out.write("}  // namespace antares\n")
+
+
+if __name__ == "__main__":
+    main()
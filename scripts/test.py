@@ -26,8 +26,14 @@ WINE_TESTS = [
     "color-test",
     "editable-text-test",
     "fixed-test",
+    "fx-test",
+    "motion-test",
     "object-data",
+    "pix-kernels-test",
+    "rotation-test",
     "shapes",
+    "special-test",
+    "target-scoring-test",
     "tint",
 ]
 
@@ -51,14 +57,72 @@ def unit_test(opts, queue, name, args=[]):
     return run(opts, queue, name, ["out/cur/%s" % name] + args)
 
 
-def diff_test(opts, queue, name, cmd, expected):
+def diff_test(opts, queue, name, cmd, expected, hash_frames=False):
+    """Runs `cmd` and diffs its output against the golden directory `expected`.
+
+    Tests that take screens compare them by hash unless --full-diff is given.
+    The hashes are checked against `expected`/frames.hash, which is diffed
+    like any other file; only screens that don't match are written out. If
+    there is no manifest yet, the golden screens themselves are hashed.
+    """
+    hash_frames = hash_frames and not opts.full_diff
+    manifest = os.path.join(expected, "frames.hash")
+    record = hash_frames and opts.record_hashes
+    by_manifest = hash_frames and not record and os.path.exists(manifest)
+    if hash_frames:
+        cmd = cmd + ["--hash-frames=%s" % (manifest if by_manifest else expected)]
     with NamedTemporaryDir() as d:
-        return run(opts, queue, name, cmd + ["--output=%s" % d]) and run(
+        if not run(opts, queue, name, cmd + ["--output=%s" % d]):
+            return False
+        if hash_frames and not hash_test(expected, d, by_manifest):
+            return False
+        exclude = ["-xscreens"] if hash_frames else []
+        if not by_manifest:
+            exclude.append("-xframes.hash")
+        if not run(
             opts,
             queue,
             name,
-            ["diff", "--strip-trailing-cr", "-ru", "-x.*", expected, d],
-        )
+            ["diff", "--strip-trailing-cr", "-ru", "-x.*"] + exclude + [expected, d],
+        ):
+            return False
+        if record:
+            shutil.copyfile(os.path.join(d, "frames.hash"), manifest)
+        return True
+
+
+def hash_test(expected, actual, by_manifest):
+    """Checks screens written with --hash-frames.
+
+    Screens that matched the expected ones were recorded in frames.hash but
+    not written, so only mismatches appear in the output. When checking
+    against a manifest, diffing it covers which screens were taken; otherwise,
+    checks that the same set of screens was taken as in `expected`.
+    """
+    written = sorted(screens(actual))
+    if written:
+        print("screens differ:\n  %s" % "\n  ".join(written))
+    if by_manifest:
+        return not written
+
+    taken = set()
+    manifest = os.path.join(actual, "frames.hash")
+    if os.path.exists(manifest):
+        with open(manifest) as f:
+            taken = set(line.split(" ")[0] for line in f if line.strip())
+    wanted = set(screens(expected))
+    if wanted - taken:
+        print("screens missing:\n  %s" % "\n  ".join(sorted(wanted - taken)))
+    if taken - wanted:
+        print("screens unexpected:\n  %s" % "\n  ".join(sorted(taken - wanted)))
+    return not written and (wanted == taken)
+
+
+def screens(d):
+    for root, _, files in os.walk(os.path.join(d, "screens")):
+        for f in files:
+            if not f.startswith("."):
+                yield os.path.relpath(os.path.join(root, f), d)
 
 
 def data_test(opts, queue, name, args=[], smoke_args=[]):
@@ -77,7 +141,7 @@ def offscreen_test(opts, queue, name, args=[]):
         expected = "test/smoke/%s" % name
     else:
         expected = "test/%s" % name
-    return diff_test(opts, queue, name, cmd + args, expected)
+    return diff_test(opts, queue, name, cmd + args, expected, hash_frames=True)
 
 
 def replay_test(opts, queue, name, args=[]):
@@ -87,7 +151,7 @@ def replay_test(opts, queue, name, args=[]):
         expected = "test/smoke/%s" % name
     else:
         expected = "test/%s" % name
-    return diff_test(opts, queue, name, cmd + args, expected)
+    return diff_test(opts, queue, name, cmd + args, expected, hash_frames=True)
 
 
 def call(args):
@@ -138,6 +202,16 @@ def main():
     parser.add_argument("--smoke", action="store_true")
     parser.add_argument("--wine", action="store_true")
     parser.add_argument("--opengl", choices=["2.0", "3.2"])
+    parser.add_argument(
+        "--full-diff",
+        action="store_true",
+        help="compare screens as images, not by hash, e.g. when re-recording them",
+    )
+    parser.add_argument(
+        "--record-hashes",
+        action="store_true",
+        help="check screens against the golden images, and update frames.hash if they match",
+    )
     parser.add_argument("-t", "--type", action="append", choices=test_types)
     parser.add_argument("test", nargs="*")
     opts = parser.parse_args()
@@ -152,6 +226,13 @@ def main():
         (unit_test, opts, queue, "color-test"),
         (unit_test, opts, queue, "editable-text-test"),
         (unit_test, opts, queue, "fixed-test"),
+        (unit_test, opts, queue, "fx-test"),
+        (unit_test, opts, queue, "motion-test"),
+        (unit_test, opts, queue, "pix-kernels-test"),
+        (unit_test, opts, queue, "resource-test"),
+        (unit_test, opts, queue, "rotation-test"),
+        (unit_test, opts, queue, "special-test"),
+        (unit_test, opts, queue, "target-scoring-test"),
         (data_test, opts, queue, "build-pix", ["--text"]),
         (data_test, opts, queue, "object-data"),
         (data_test, opts, queue, "shapes"),
@@ -87,13 +87,13 @@ pn::string_view about() { return *plug.info.about; }
 
 std::function<pn::string_view()> prologue(pn::string_view chapter) {
     return [chapter]() -> pn::string_view {
-        return *plug.levels.find(chapter.copy())->second.solo.prologue;
+        return *Level::get(chapter)->solo.prologue;
     };
 }
 
 std::function<pn::string_view()> epilogue(pn::string_view chapter) {
     return [chapter]() -> pn::string_view {
-        return *plug.levels.find(chapter.copy())->second.solo.epilogue;
+        return *Level::get(chapter)->solo.epilogue;
     };
 }
 
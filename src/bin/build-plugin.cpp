@@ -0,0 +1,267 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2008-2017 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <pn/input>
+#include <pn/output>
+#include <pn/value>
+#include <set>
+#include <sfz/sfz.hpp>
+
+#include "config/preferences.hpp"
+#include "data/audio.hpp"
+#include "data/bundle.hpp"
+#include "data/level.hpp"
+#include "data/plugin.hpp"
+#include "data/resource.hpp"
+#include "game/globals.hpp"
+#include "lang/exception.hpp"
+#include "video/text-driver.hpp"
+
+namespace args = sfz::args;
+
+namespace antares {
+namespace {
+
+void usage(pn::output_view out, pn::string_view progname, int retcode) {
+    out.format(
+            "usage: {0} [OPTIONS] directory output\n"
+            "\n"
+            "  Compiles a plugin directory into a bundle\n"
+            "\n"
+            "  arguments:\n"
+            "    directory           the plugin to compile\n"
+            "    output              where to write the bundle\n"
+            "\n"
+            "  options:\n"
+            "    -h, --help          display this help screen\n",
+            progname);
+    exit(retcode);
+}
+
+// Collects the plugin's files, following symlinks. Hidden files and directories (.DS_Store,
+// .git/) are skipped.
+class FileCollector : public sfz::TreeWalker {
+  public:
+    FileCollector(pn::string_view root, std::map<pn::string, pn::data>* files)
+            : _root_size(root.size()), _files(files), _hidden_depth(0) {}
+
+    void file(pn::string_view name, const sfz::Stat& st) const override {
+        if (_hidden_depth || hidden(name)) {
+            return;
+        }
+        pn::data d;
+        if (pn::input{name, pn::binary}.read(pn::all(d)).error()) {
+            throw std::runtime_error(pn::format("{0}: read error", name).c_str());
+        }
+        _files->emplace(name.substr(_root_size + 1).copy(), std::move(d));
+    }
+
+    void pre_directory(pn::string_view name, const sfz::Stat& st) const override {
+        if (_hidden_depth || hidden(name)) {
+            ++_hidden_depth;
+        }
+    }
+
+    void post_directory(pn::string_view name, const sfz::Stat& st) const override {
+        if (_hidden_depth) {
+            --_hidden_depth;
+        }
+    }
+
+    void cycle_directory(pn::string_view name, const sfz::Stat& st) const override {
+        throw std::runtime_error(pn::format("{0}: symlink cycle", name).c_str());
+    }
+    void symlink(pn::string_view name, const sfz::Stat& st) const override {
+        throw std::runtime_error(pn::format("{0}: unexpected symlink", name).c_str());
+    }
+    void broken_symlink(pn::string_view name, const sfz::Stat& st) const override {
+        throw std::runtime_error(pn::format("{0}: broken symlink", name).c_str());
+    }
+    void other(pn::string_view name, const sfz::Stat& st) const override {
+        throw std::runtime_error(pn::format("{0}: not a regular file", name).c_str());
+    }
+
+  private:
+    // The root itself may be named "." or "..", so only names below it count.
+    bool hidden(pn::string_view name) const {
+        return (name.size() > _root_size) && (sfz::path::basename(name).substr(0, 1) == ".");
+    }
+
+    const int                             _root_size;
+    std::map<pn::string, pn::data>* const _files;
+    mutable int                           _hidden_depth;
+};
+
+bool startswith(pn::string_view s, pn::string_view prefix) {
+    return (s.size() >= prefix.size()) && (s.substr(0, prefix.size()) == prefix);
+}
+
+bool endswith(pn::string_view s, pn::string_view suffix) {
+    return (s.size() >= suffix.size()) && (s.substr(s.size() - suffix.size()) == suffix);
+}
+
+pn::data decode_png(pn::data_view in) {
+    pn::data out;
+    write_pix(out.output().check(), read_png(in));
+    return out;
+}
+
+template <SoundData (*convert)(pn::data_view)>
+pn::data decode_audio(pn::data_view in) {
+    pn::data out;
+    write_pcm(out.output().check(), convert(in));
+    return out;
+}
+
+// Replaces sprites and sounds with their decoded forms; see data/bundle.hpp. If a sound exists
+// in more than one format, the first in path order is kept, which is also the one that
+// Resource::sound() would load.
+void decode(std::map<pn::string, pn::data>* files) {
+    static const struct {
+        const char* prefix;
+        const char* suffix;
+        const char* decoded_suffix;
+        pn::data (*fn)(pn::data_view);
+    } fmts[] = {
+            {"sprites/", "/image.png", "/image.pix", decode_png},
+            {"sprites/", "/overlay.png", "/overlay.pix", decode_png},
+            {"sounds/", ".aiff", ".pcm", decode_audio<sndfile::convert>},
+            {"sounds/", ".s3m", ".pcm", decode_audio<modplug::convert>},
+            {"sounds/", ".xm", ".pcm", decode_audio<modplug::convert>},
+    };
+
+    std::map<pn::string, pn::data> decoded;
+    for (auto it = files->begin(); it != files->end();) {
+        pn::string_view path = it->first;
+        auto fmt = std::find_if(std::begin(fmts), std::end(fmts), [path](decltype(fmts[0]) f) {
+            return startswith(path, f.prefix) && endswith(path, f.suffix);
+        });
+        if (fmt == std::end(fmts)) {
+            ++it;
+            continue;
+        }
+        pn::string_view stem = path.substr(0, path.size() - pn::string_view{fmt->suffix}.size());
+        try {
+            decoded.emplace(pn::format("{0}{1}", stem, fmt->decoded_suffix), fmt->fn(it->second));
+        } catch (...) {
+            std::throw_with_nested(std::runtime_error(path.copy().c_str()));
+        }
+        it = files->erase(it);
+    }
+    for (auto& kv : decoded) {
+        files->emplace(kv.first.copy(), std::move(kv.second));
+    }
+}
+
+// Loads every level, object, and race, so that a plugin that can't be loaded isn't bundled.
+// Objects that serve as other objects' templates needn't be complete, so those may fail.
+void check_plugin(const std::map<pn::string, pn::data>& files) {
+    for (const auto& kv : plug.levels) {
+        Level::get(kv.first);
+    }
+
+    std::set<pn::string> templates;
+    for (const auto& kv : files) {
+        pn::string_view path = kv.first;
+        if (!startswith(path, "objects/") || !endswith(path, ".pn")) {
+            continue;
+        }
+        pn::value  x;
+        pn_error_t e;
+        if (!pn::parse(pn::data_view{kv.second}.input(), &x, &e)) {
+            throw std::runtime_error(pn::format(
+                    "{0}: {1}:{2}: {3}", path, e.lineno, e.column, pn_strerror(e.code)).c_str());
+        }
+        if (x.is_map() && x.as_map().get("template").is_string()) {
+            templates.insert(x.as_map().get("template").as_string().copy());
+        }
+    }
+    for (const pn::string& name : Resource::list_objects()) {
+        try {
+            Resource::object(name);
+        } catch (std::runtime_error&) {
+            if (templates.find(name) == templates.end()) {
+                throw;
+            }
+        }
+    }
+    Resource::clear_templates();
+
+    for (const pn::string& name : Resource::list_races()) {
+        Resource::race(name);
+    }
+}
+
+void main(int argc, char* const* argv) {
+    args::callbacks callbacks;
+
+    sfz::optional<pn::string> directory;
+    sfz::optional<pn::string> output;
+    callbacks.argument = [&directory, &output](pn::string_view arg) {
+        if (!directory.has_value()) {
+            directory.emplace(arg.copy());
+        } else if (!output.has_value()) {
+            output.emplace(arg.copy());
+        } else {
+            return false;
+        }
+        return true;
+    };
+
+    callbacks.short_option = [&argv](pn::rune opt, const args::callbacks::get_value_f& get_value) {
+        switch (opt.value()) {
+            case 'h': usage(pn::out, sfz::path::basename(argv[0]), 0); return true;
+            default: return false;
+        }
+    };
+
+    callbacks.long_option =
+            [&callbacks](pn::string_view opt, const args::callbacks::get_value_f& get_value) {
+                if (opt == "help") {
+                    return callbacks.short_option(pn::rune{'h'}, get_value);
+                } else {
+                    return false;
+                }
+            };
+
+    args::parse(argc - 1, argv + 1, callbacks);
+    if (!directory.has_value()) {
+        throw std::runtime_error("missing required argument 'directory'");
+    } else if (!output.has_value()) {
+        throw std::runtime_error("missing required argument 'output'");
+    }
+
+    NullPrefsDriver prefs;
+    TextVideoDriver video({640, 480}, {});
+    init_globals();
+    PluginInit(sfz::make_optional<pn::string_view>(*directory));
+
+    std::map<pn::string, pn::data> files;
+    sfz::walk(*directory, sfz::WALK_LOGICAL, FileCollector(*directory, &files));
+    check_plugin(files);
+    decode(&files);
+    PluginBundle::write(*output, files);
+}
+
+}  // namespace
+}  // namespace antares
+
+int main(int argc, char* const* argv) { return antares::wrap_main(antares::main, argc, argv); }
@@ -0,0 +1,185 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2008-2017 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include <algorithm>
+#include <chrono>
+#include <pn/input>
+#include <pn/output>
+#include <sfz/sfz.hpp>
+
+#include "config/dirs.hpp"
+#include "drawing/pix-map.hpp"
+#include "lang/exception.hpp"
+
+namespace args = sfz::args;
+
+namespace antares {
+namespace {
+
+const int kRounds     = 5;
+const int kAtlasWidth = 4096;
+
+void usage(pn::output_view out, pn::string_view progname, int retcode) {
+    out.format(
+            "usage: {0} [OPTIONS] [directory]\n"
+            "\n"
+            "  Times decoding every sprite image in the factory scenario\n"
+            "\n"
+            "  arguments:\n"
+            "    directory           sprites to decode (default: factory scenario)\n"
+            "\n"
+            "  options:\n"
+            "    -h, --help          display this help screen\n",
+            progname);
+    exit(retcode);
+}
+
+class PngCollector : public sfz::TreeWalker {
+  public:
+    PngCollector(std::vector<pn::string>* paths) : _paths(paths) {}
+
+    void file(pn::string_view name, const sfz::Stat& st) const override {
+        if ((name.size() > 4) && (name.substr(name.size() - 4) == ".png")) {
+            _paths->push_back(name.copy());
+        }
+    }
+
+    void pre_directory(pn::string_view name, const sfz::Stat& st) const override {}
+    void cycle_directory(pn::string_view name, const sfz::Stat& st) const override {}
+    void post_directory(pn::string_view name, const sfz::Stat& st) const override {}
+    void symlink(pn::string_view name, const sfz::Stat& st) const override {}
+    void broken_symlink(pn::string_view name, const sfz::Stat& st) const override {}
+    void other(pn::string_view name, const sfz::Stat& st) const override {}
+
+  private:
+    std::vector<pn::string>* const _paths;
+};
+
+// Places each of `sizes` on shelves, left to right and top to bottom, and returns the height
+// of the atlas.
+int pack(const std::vector<Size>& sizes, std::vector<Rect>* rects) {
+    Point at{0, 0};
+    int   shelf = 0;
+    for (Size size : sizes) {
+        if (at.h + size.width > kAtlasWidth) {
+            at    = Point{0, at.v + shelf};
+            shelf = 0;
+        }
+        rects->push_back(Rect{at, size});
+        at.h += size.width;
+        shelf = std::max(shelf, size.height);
+    }
+    return at.v + shelf;
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    std::chrono::duration<double, std::milli> ms = std::chrono::steady_clock::now() - start;
+    return ms.count();
+}
+
+// Reads each file as a stream, into a new ArrayPixMap, as sprites were loaded before.
+double decode_stream(const std::vector<pn::string>& paths) {
+    auto start = std::chrono::steady_clock::now();
+    for (const pn::string& path : paths) {
+        read_png(pn::input{path, pn::binary});
+    }
+    return elapsed_ms(start);
+}
+
+// Maps each file and decodes it into a new ArrayPixMap.
+double decode_mapped(const std::vector<pn::string>& paths) {
+    auto start = std::chrono::steady_clock::now();
+    for (const pn::string& path : paths) {
+        read_png(sfz::mapped_file(path).data());
+    }
+    return elapsed_ms(start);
+}
+
+// Maps each file and decodes it into its own region of a single, preallocated atlas.
+double decode_atlas(const std::vector<pn::string>& paths, const std::vector<Rect>& rects,
+                    ArrayPixMap* atlas) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < paths.size(); ++i) {
+        PixMap::View view = atlas->view(rects[i]);
+        read_png(sfz::mapped_file(paths[i]).data(), view);
+    }
+    return elapsed_ms(start);
+}
+
+void main(int argc, char* const* argv) {
+    args::callbacks callbacks;
+
+    sfz::optional<pn::string> directory;
+    callbacks.argument = [&directory](pn::string_view arg) {
+        if (!directory.has_value()) {
+            directory.emplace(arg.copy());
+        } else {
+            return false;
+        }
+        return true;
+    };
+
+    callbacks.short_option = [&argv](pn::rune opt, const args::callbacks::get_value_f& get_value) {
+        switch (opt.value()) {
+            case 'h': usage(pn::out, sfz::path::basename(argv[0]), 0); return true;
+            default: return false;
+        }
+    };
+
+    callbacks.long_option =
+            [&callbacks](pn::string_view opt, const args::callbacks::get_value_f& get_value) {
+                if (opt == "help") {
+                    return callbacks.short_option(pn::rune{'h'}, get_value);
+                } else {
+                    return false;
+                }
+            };
+
+    args::parse(argc - 1, argv + 1, callbacks);
+    if (!directory.has_value()) {
+        directory.emplace(pn::format("{0}/sprites", factory_scenario_path()));
+    }
+
+    std::vector<pn::string> paths;
+    sfz::walk(*directory, sfz::WALK_PHYSICAL, PngCollector(&paths));
+
+    std::vector<Size> sizes;
+    int64_t           pixels = 0;
+    for (const pn::string& path : paths) {
+        sizes.push_back(png_size(sfz::mapped_file(path).data()));
+        pixels += sizes.back().width * sizes.back().height;
+    }
+    std::vector<Rect> rects;
+    ArrayPixMap       atlas(kAtlasWidth, pack(sizes, &rects));
+    pn::out.format("{0} images ({1} Mpixels)\n", paths.size(), pixels / 1e6);
+
+    double stream = 0, mapped = 0, atlased = 0;
+    for (int i = 0; i < kRounds; ++i) {
+        stream += decode_stream(paths);
+        mapped += decode_mapped(paths);
+        atlased += decode_atlas(paths, rects, &atlas);
+    }
+    pn::out.format("streamed:         {0} ms\n", stream / kRounds);
+    pn::out.format("mapped:           {0} ms\n", mapped / kRounds);
+    pn::out.format("mapped to atlas:  {0} ms\n", atlased / kRounds);
+}
+
+}  // namespace
+}  // namespace antares
+
+int main(int argc, char* const* argv) { return antares::wrap_main(antares::main, argc, argv); }
@@ -0,0 +1,137 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2008-2017 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include <chrono>
+#include <pn/output>
+#include <sfz/sfz.hpp>
+
+#include "config/preferences.hpp"
+#include "data/base-object.hpp"
+#include "data/level.hpp"
+#include "data/plugin.hpp"
+#include "data/resource.hpp"
+#include "game/globals.hpp"
+#include "lang/exception.hpp"
+#include "video/text-driver.hpp"
+
+namespace args = sfz::args;
+
+namespace antares {
+namespace {
+
+const int kRounds = 5;
+
+void usage(pn::output_view out, pn::string_view progname, int retcode) {
+    out.format(
+            "usage: {0} [OPTIONS]\n"
+            "\n"
+            "  Times loading every object and level in the factory scenario\n"
+            "\n"
+            "  options:\n"
+            "    -h, --help          display this help screen\n",
+            progname);
+    exit(retcode);
+}
+
+// Loads each of `names`, returning the elapsed time in milliseconds. If `share_templates` is
+// false, the memoized templates are cleared before every object, so that its templates are
+// resolved from scratch, as they were before templates were memoized.
+double load_all(const std::vector<pn::string>& names, bool share_templates) {
+    auto start = std::chrono::steady_clock::now();
+    Resource::clear_templates();
+    for (const pn::string& name : names) {
+        if (!share_templates) {
+            Resource::clear_templates();
+        }
+        Resource::object(name);
+    }
+    std::chrono::duration<double, std::milli> ms = std::chrono::steady_clock::now() - start;
+    return ms.count();
+}
+
+// Loads each of `names` as a level, returning the elapsed time in milliseconds.
+double load_levels(const std::vector<pn::string>& names) {
+    auto start = std::chrono::steady_clock::now();
+    for (const pn::string& name : names) {
+        Resource::level(name);
+    }
+    std::chrono::duration<double, std::milli> ms = std::chrono::steady_clock::now() - start;
+    return ms.count();
+}
+
+void main(int argc, char* const* argv) {
+    args::callbacks callbacks;
+
+    callbacks.argument = [](pn::string_view arg) { return false; };
+
+    callbacks.short_option = [&argv](pn::rune opt, const args::callbacks::get_value_f& get_value) {
+        switch (opt.value()) {
+            case 'h': usage(pn::out, sfz::path::basename(argv[0]), 0); return true;
+            default: return false;
+        }
+    };
+
+    callbacks.long_option =
+            [&callbacks](pn::string_view opt, const args::callbacks::get_value_f& get_value) {
+                if (opt == "help") {
+                    return callbacks.short_option(pn::rune{'h'}, get_value);
+                } else {
+                    return false;
+                }
+            };
+
+    args::parse(argc - 1, argv + 1, callbacks);
+
+    NullPrefsDriver prefs;
+    TextVideoDriver video({640, 480}, {});
+    init_globals();
+    PluginInit(sfz::nullopt);
+
+    // Some files exist only to be used as templates, and aren't complete objects themselves.
+    std::vector<pn::string> names;
+    int                     skipped = 0;
+    for (pn::string& name : Resource::list_objects()) {
+        try {
+            Resource::object(name);
+            names.push_back(std::move(name));
+        } catch (std::runtime_error&) {
+            ++skipped;
+        }
+    }
+    pn::out.format("{0} objects ({1} skipped)\n", names.size(), skipped);
+
+    double separate = 0, shared = 0;
+    for (int i = 0; i < kRounds; ++i) {
+        separate += load_all(names, false);
+        shared += load_all(names, true);
+    }
+    pn::out.format("separate sessions: {0} ms\n", separate / kRounds);
+    pn::out.format("one session:       {0} ms\n", shared / kRounds);
+
+    std::vector<pn::string> levels = Resource::list_levels();
+    double                  total  = 0;
+    for (int i = 0; i < kRounds; ++i) {
+        total += load_levels(levels);
+    }
+    pn::out.format("all levels:        {0} ms ({1} levels)\n", total / kRounds, levels.size());
+}
+
+}  // namespace
+}  // namespace antares
+
+int main(int argc, char* const* argv) { return antares::wrap_main(antares::main, argc, argv); }
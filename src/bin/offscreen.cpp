@@ -61,7 +61,10 @@ void usage(pn::output_view out, pn::string_view progname, int retcode) {
             "\n  options:"
             "\n    -o, --output=OUTPUT  place output in this directory"
             "\n    -t, --text           produce text output"
+            "\n        --hash-frames=GOLDEN"
+            "\n                         only write screenshots that differ from GOLDEN"
             "\n        --opengl=2.0|3.2 select OpenGL version (default: 3.2)"
+            "\n        --stats          print scheduler counters to stderr"
             "\n    -h, --help           display this help screen"
             "\n",
             progname);
@@ -85,6 +88,8 @@ void main(int argc, char* const* argv) {
     bool                      text         = false;
     std::pair<int, int>       gl_version   = {3, 2};
     pn::string_view           glsl_version = "330 core";
+    sfz::optional<pn::string> hash_frames;
+    bool                      stats        = false;
     callbacks.short_option = [&](pn::rune opt, const args::callbacks::get_value_f& get_value) {
         switch (opt.value()) {
             case 'o': output_dir.emplace(get_value().copy()); return true;
@@ -100,6 +105,12 @@ void main(int argc, char* const* argv) {
             return callbacks.short_option(pn::rune{'o'}, get_value);
         } else if (opt == "text") {
             return callbacks.short_option(pn::rune{'t'}, get_value);
+        } else if (opt == "stats") {
+            stats = true;
+            return true;
+        } else if (opt == "hash-frames") {
+            hash_frames.emplace(get_value().copy());
+            return true;
         } else if (opt == "opengl") {
             if (get_value() == "2.0") {
                 gl_version   = {2, 0};
@@ -154,11 +165,24 @@ void main(int argc, char* const* argv) {
 
     if (text) {
         TextVideoDriver video({640, 480}, output_dir);
+        if (hash_frames.has_value()) {
+            video.set_hash_frames(*hash_frames);
+        }
         video.loop(new Master(sfz::nullopt, 14586), scheduler);
     } else {
         OffscreenVideoDriver video({640, 480}, 1, gl_version, glsl_version, output_dir);
+        if (hash_frames.has_value()) {
+            video.set_hash_frames(*hash_frames);
+        }
         video.loop(new Master(sfz::nullopt, 14586), scheduler);
     }
+
+    if (stats) {
+        const auto& c = scheduler.counters();
+        pn::err.format(
+                "iterations: {0}\nevents: {1}\ntimers: {2}\nsnapshots: {3}\nticks: {4}\n",
+                c.iterations, c.events, c.timers, c.snapshots, c.ticks);
+    }
 }
 
 void fast_motion(EventScheduler& scheduler) {
@@ -185,9 +209,7 @@ void fast_motion(EventScheduler& scheduler) {
 
     scheduler.schedule_key(Key::N5, 2020, 2400);
     scheduler.schedule_key(Key::F6, 2020, 2400);
-    for (int i = 2200; i < 2290; i += 10) {
-        scheduler.schedule_snapshot(i);
-    }
+    scheduler.schedule_snapshots(2200, 10, 2290);
 
     scheduler.schedule_snapshot(2400);
 
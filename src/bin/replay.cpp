@@ -28,6 +28,7 @@
 #include "data/resource.hpp"
 #include "drawing/color.hpp"
 #include "drawing/pix-map.hpp"
+#include "drawing/pix-table.hpp"
 #include "game/admiral.hpp"
 #include "game/cheat.hpp"
 #include "game/cursor.hpp"
@@ -46,6 +47,7 @@
 #include "math/random.hpp"
 #include "math/rotation.hpp"
 #include "sound/driver.hpp"
+#include "sound/fx.hpp"
 #include "sound/music.hpp"
 #include "ui/card.hpp"
 #include "ui/interface-handling.hpp"
@@ -161,7 +163,20 @@ void usage(pn::output_view out, pn::string_view progname, int retcode) {
             "\n    -h, --height=HEIGHT  screen height (default: 480)"
             "\n    -t, --text           produce text output"
             "\n    -s, --smoke          run as smoke text"
+            "\n    -z, --gzip           compress text output with gzip (not with --hash-frames)"
+            "\n        --hash-frames=GOLDEN"
+            "\n                         only write screenshots that differ from GOLDEN"
+            "\n        --video-out=PATH|-"
+            "\n                         stream screenshots as YUV4MPEG2 video, not PNGs"
             "\n        --opengl=2.0|3.2 select OpenGL version (default: 3.2)"
+            "\n        --batched-ai     use batched AI target scoring (won't match replay)"
+            "\n        --influence-map  use influence map for local strength (won't match replay)"
+            "\n        --shader-tinting"
+            "\n                         tint sprites when drawing them, not when loading them"
+            "\n        --voice-mixer    mix sounds with virtual voices (changes sound log)"
+            "\n        --stats          print scheduler counters to stderr"
+            "\n        --locality-report"
+            "\n                         print accuracy of the influence map against exact values"
             "\n        --help           display this help screen"
             "\n",
             progname);
@@ -189,6 +204,11 @@ void main(int argc, char* const* argv) {
     bool                      smoke        = false;
     std::pair<int, int>       gl_version   = {3, 2};
     pn::string_view           glsl_version = "330 core";
+    bool                      report       = false;
+    sfz::optional<pn::string> video_out;
+    sfz::optional<pn::string> hash_frames;
+    bool                      gzip         = false;
+    bool                      stats        = false;
     callbacks.short_option = [&](pn::rune opt, const args::callbacks::get_value_f& get_value) {
         switch (opt.value()) {
             case 'o': output_dir.emplace(get_value().copy()); return true;
@@ -197,6 +217,7 @@ void main(int argc, char* const* argv) {
             case 'h': sfz::args::integer_option(get_value(), &height); return true;
             case 't': text = true; return true;
             case 's': smoke = true; return true;
+            case 'z': gzip = true; return true;
             default: return false;
         }
     };
@@ -215,6 +236,14 @@ void main(int argc, char* const* argv) {
             return callbacks.short_option(pn::rune{'t'}, get_value);
         } else if (opt == "smoke") {
             return callbacks.short_option(pn::rune{'s'}, get_value);
+        } else if (opt == "gzip") {
+            return callbacks.short_option(pn::rune{'z'}, get_value);
+        } else if (opt == "hash-frames") {
+            hash_frames.emplace(get_value().copy());
+            return true;
+        } else if (opt == "video-out") {
+            video_out.emplace(get_value().copy());
+            return true;
         } else if (opt == "opengl") {
             if (get_value() == "2.0") {
                 gl_version   = {2, 0};
@@ -226,6 +255,24 @@ void main(int argc, char* const* argv) {
                 throw std::runtime_error("invalid OpenGL version");
             }
             return true;
+        } else if (opt == "batched-ai") {
+            Admiral::set_scoring(Admiral::Scoring::BATCHED);
+            return true;
+        } else if (opt == "influence-map") {
+            set_locality(Locality::INFLUENCE_MAP);
+            return true;
+        } else if (opt == "shader-tinting") {
+            NatePixTable::set_tinting(NatePixTable::Tinting::SHADER);
+            return true;
+        } else if (opt == "voice-mixer") {
+            SoundFX::set_mixing(SoundFX::Mixing::VOICES);
+            return true;
+        } else if (opt == "stats") {
+            stats = true;
+            return true;
+        } else if (opt == "locality-report") {
+            report = true;
+            return true;
         } else if (opt == "help") {
             usage(pn::out, sfz::path::basename(argv[0]), 0);
             return true;
@@ -237,6 +284,11 @@ void main(int argc, char* const* argv) {
     args::parse(argc - 1, argv + 1, callbacks);
     if (!replay_path.has_value()) {
         throw std::runtime_error("missing required argument 'replay'");
+    } else if (video_out.has_value() && (text || smoke)) {
+        throw std::runtime_error("--video-out requires OpenGL output");
+    } else if (gzip && hash_frames.has_value()) {
+        // frames.hash would name screens/*.txt, but the files would be screens/*.txt.gz.
+        throw std::runtime_error("--gzip can't be used with --hash-frames");
     }
 
     if (output_dir.has_value()) {
@@ -249,10 +301,7 @@ void main(int argc, char* const* argv) {
 
     EventScheduler scheduler;
     scheduler.schedule_event(unique_ptr<Event>(new MouseMoveEvent(wall_time(), Point(320, 240))));
-    // TODO(sfiera): add recurring snapshots to OffscreenVideoDriver.
-    for (int64_t i = 1; i < 72000; i += interval) {
-        scheduler.schedule_snapshot(i);
-    }
+    scheduler.schedule_snapshots(1, interval, 72000);
 
     unique_ptr<SoundDriver> sound;
     if (!smoke && output_dir.has_value()) {
@@ -263,17 +312,48 @@ void main(int argc, char* const* argv) {
     }
     NullLedger ledger;
 
+    LocalityReport locality_report;
+    if (report) {
+        set_locality_report(&locality_report);
+    }
+
     pn::input replay_file{*replay_path, pn::binary};
     if (smoke) {
         TextVideoDriver video({width, height}, sfz::optional<pn::string>());
         video.loop(new ReplayMaster(replay_file, output_dir), scheduler);
     } else if (text) {
         TextVideoDriver video({width, height}, output_dir);
+        video.set_gzip(gzip);
+        if (hash_frames.has_value()) {
+            video.set_hash_frames(*hash_frames);
+        }
         video.loop(new ReplayMaster(replay_file, output_dir), scheduler);
     } else {
         OffscreenVideoDriver video({width, height}, 1, gl_version, glsl_version, output_dir);
+        if (video_out.has_value()) {
+            video.set_video_out(*video_out, interval);
+        }
+        if (hash_frames.has_value()) {
+            video.set_hash_frames(*hash_frames);
+        }
         video.loop(new ReplayMaster(replay_file, output_dir), scheduler);
     }
+
+    if (stats) {
+        const auto& c = scheduler.counters();
+        pn::err.format(
+                "iterations: {0}\nevents: {1}\ntimers: {2}\nsnapshots: {3}\nticks: {4}\n",
+                c.iterations, c.events, c.timers, c.snapshots, c.ticks);
+    }
+
+    if (report) {
+        set_locality_report(nullptr);
+        const auto& r = locality_report;
+        pn::out.format(
+                "samples: {0}\nexact: {1}\nfriend error: {2}\nfoe error: {3}\n", r.samples,
+                r.exact, r.friend_total ? (r.friend_error / r.friend_total) : 0.0,
+                r.foe_total ? (r.foe_error / r.foe_total) : 0.0);
+    }
 }
 
 }  // namespace
@@ -0,0 +1,142 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2008-2017 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include <chrono>
+#include <pn/output>
+#include <random>
+#include <sfz/sfz.hpp>
+#include <vector>
+
+#include "data/base-object.hpp"
+#include "game/target-scoring.hpp"
+#include "lang/exception.hpp"
+
+namespace args = sfz::args;
+
+namespace antares {
+namespace {
+
+const int kRounds  = 5;
+const int kShips   = 200;
+const int kTargets = 1000;
+
+void usage(pn::output_view out, pn::string_view progname, int retcode) {
+    out.format(
+            "usage: {0} [OPTIONS]\n"
+            "\n"
+            "  Times scoring random ships against random targets, one pair at a time and in\n"
+            "  batches, as computer admirals do\n"
+            "\n"
+            "  options:\n"
+            "    -h, --help          display this help screen\n",
+            progname);
+    exit(retcode);
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    std::chrono::duration<double, std::milli> ms = std::chrono::steady_clock::now() - start;
+    return ms.count();
+}
+
+void main(int argc, char* const* argv) {
+    args::callbacks callbacks;
+
+    callbacks.argument = [](pn::string_view arg) { return false; };
+
+    callbacks.short_option = [&argv](pn::rune opt, const args::callbacks::get_value_f& get_value) {
+        switch (opt.value()) {
+            case 'h': usage(pn::out, sfz::path::basename(argv[0]), 0); return true;
+            default: return false;
+        }
+    };
+
+    callbacks.long_option =
+            [&callbacks](pn::string_view opt, const args::callbacks::get_value_f& get_value) {
+                if (opt == "help") {
+                    return callbacks.short_option(pn::rune{'h'}, get_value);
+                } else {
+                    return false;
+                }
+            };
+
+    args::parse(argc - 1, argv + 1, callbacks);
+
+    std::mt19937 random{0};
+    auto         coordinate = [&random] {
+        return 0x3ffe0000 + static_cast<int32_t>(random() % 0x40000);
+    };
+
+    std::vector<ScoringShip> ships;
+    for (int i = 0; i < kShips; ++i) {
+        ScoringShip s;
+        s.owner        = random() % 4;
+        s.order_flags  = (random() % 2) ? kSoftTargetIsBase : kSoftTargetIsLocal;
+        s.escort_class = random() % 4;
+        s.guarding     = random() % 2;
+        s.free         = s.guarding || (random() % 2);
+        s.blitzkrieg   = false;
+        s.h            = coordinate();
+        s.v            = coordinate();
+        ships.push_back(s);
+    }
+
+    std::vector<ScoringTarget> targets;
+    ScoringTargets             batch;
+    for (int i = 0; i < kTargets; ++i) {
+        ScoringTarget t;
+        t.owner                 = static_cast<int32_t>(random() % 5) - 1;
+        t.is_destination        = (random() % 8) == 0;
+        t.escort_class          = random() % 4;
+        t.escort_strength       = Fixed::from_val(random() % 1024);
+        t.escort_need           = Fixed::from_val(random() % 1024);
+        t.h                     = coordinate();
+        t.v                     = coordinate();
+        t.local_owner           = t.owner;
+        t.local_friend_strength = Fixed::from_val(random() % 4096);
+        t.local_foe_strength    = Fixed::from_val(random() % 4096);
+        targets.push_back(t);
+        batch.push_back(t);
+    }
+    pn::out.format("{0} ships, {1} targets\n", ships.size(), targets.size());
+
+    std::vector<int32_t> tags(targets.size(), 0);
+    std::vector<Fixed>   values(targets.size());
+    double               scalar = 0, batched = 0;
+    for (int i = 0; i < kRounds; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        for (const ScoringShip& s : ships) {
+            for (int j = 0; j < targets.size(); ++j) {
+                values[j] = target_value(s, targets[j], false, false);
+            }
+        }
+        scalar += elapsed_ms(start);
+
+        start = std::chrono::steady_clock::now();
+        for (const ScoringShip& s : ships) {
+            batch.score(s, tags.data(), tags.data(), values.data());
+        }
+        batched += elapsed_ms(start);
+    }
+    pn::out.format("one pair at a time:  {0} ms\n", scalar / kRounds);
+    pn::out.format("batched:             {0} ms\n", batched / kRounds);
+}
+
+}  // namespace
+}  // namespace antares
+
+int main(int argc, char* const* argv) { return antares::wrap_main(antares::main, argc, argv); }
@@ -23,9 +23,12 @@
 #include <string.h>
 
 #include <memory>
+#include <mutex>
 #include <pn/output>
 #include <stdexcept>
 
+#include "lang/defines.hpp"
+
 namespace antares {
 
 namespace sndfile {
@@ -105,71 +108,175 @@ static sf_count_t sf_vio_tell(void* user_data) {
     return reinterpret_cast<VirtualFile*>(user_data)->tell();
 }
 
-SoundData convert(pn::data_view in) {
-    SF_VIRTUAL_IO io = {};
-    io.get_filelen   = sf_vio_get_filelen;
-    io.seek          = sf_vio_seek;
-    io.read          = sf_vio_read;
-    io.write         = sf_vio_write;
-    io.tell          = sf_vio_tell;
+static SNDFILE* open_virtual(VirtualFile* file, SF_INFO* info) {
+    static SF_VIRTUAL_IO io = {
+            sf_vio_get_filelen, sf_vio_seek, sf_vio_read, sf_vio_write, sf_vio_tell,
+    };
+
+    *info         = SF_INFO{};
+    SNDFILE* sndf = sf_open_virtual(&io, SFM_READ, info, file);
+    if (!sndf) {
+        throw std::runtime_error(sf_strerror(NULL));
+    }
+
+    if (info->channels > 2) {
+        sf_close(sndf);
+        throw std::runtime_error(
+                pn::format("audio file has {0} channels", info->channels).c_str());
+    }
+    return sndf;
+}
 
+SoundData convert(pn::data_view in) {
     VirtualFile userdata = {};
     userdata.data        = in;
     userdata.pointer     = 0;
 
-    SF_INFO info = {};
+    SF_INFO                                       info;
+    std::unique_ptr<SNDFILE, decltype(&sf_close)> file(open_virtual(&userdata, &info), sf_close);
+
+    // The header gives the length, so decode straight into a buffer of that size. It's trimmed
+    // afterwards in case the file is shorter than it claims.
+    const int frame_size = sizeof(int16_t) * info.channels;
+    SoundData s;
+    s.frequency = info.samplerate;
+    s.channels  = info.channels;
+    s.data.resize(info.frames * frame_size);
+    sf_count_t frames =
+            sf_readf_short(file.get(), reinterpret_cast<short*>(s.data.data()), info.frames);
+    s.data.resize(frames * frame_size);
+    return s;
+}
 
-    std::unique_ptr<SNDFILE, decltype(&sf_close)> file(
-            sf_open_virtual(&io, SFM_READ, &info, &userdata), sf_close);
+namespace {
 
-    if (!file.get()) {
-        throw std::runtime_error(sf_strerror(NULL));
+class SndfileStream : public SoundStream {
+  public:
+    SndfileStream(pn::data in)
+            : _data(std::move(in)), _userdata{_data, 0}, _file(nullptr, sf_close) {
+        _file.reset(open_virtual(&_userdata, &_info));
     }
 
-    if (info.channels > 2) {
-        throw std::runtime_error(pn::format("audio file has {0} channels", info.channels).c_str());
-    }
+    int channels() const override { return _info.channels; }
+    int frequency() const override { return _info.samplerate; }
 
-    SoundData s;
-    s.frequency = info.samplerate;
-    s.channels  = info.channels;
-    int16_t shorts[1024];
-    while (auto count = sf_read_short(file.get(), shorts, 1024)) {
-        s.data += pn::data_view{reinterpret_cast<uint8_t*>(shorts),
-                                static_cast<int>(sizeof(int16_t) * count)};
+    int read(uint8_t* data, int size) override {
+        sf_count_t frames = size / (sizeof(int16_t) * _info.channels);
+        frames            = sf_readf_short(_file.get(), reinterpret_cast<short*>(data), frames);
+        return frames * sizeof(int16_t) * _info.channels;
     }
-    return s;
+
+    void rewind() override { sf_seek(_file.get(), 0, SEEK_SET); }
+
+  private:
+    pn::data                                      _data;
+    VirtualFile                                   _userdata;
+    SF_INFO                                       _info;
+    std::unique_ptr<SNDFILE, decltype(&sf_close)> _file;
+};
+
+}  // namespace
+
+std::unique_ptr<SoundStream> stream(pn::data in) {
+    return std::unique_ptr<SoundStream>(new SndfileStream(std::move(in)));
 }
 
 }  // namespace sndfile
 
 namespace modplug {
 
-SoundData convert(pn::data_view in) {
+using File = std::unique_ptr<::ModPlugFile, decltype(&ModPlug_Unload)>;
+
+const int kChannels  = 2;
+const int kFrequency = 44100;
+
+// libmodplug isn't re-entrant: its settings are global, and so is some of its mixer's state. So
+// every call into it, from loading a file to reading and unloading it, is made under this lock.
+// That lets sounds decode on worker threads while music streams on another.
+static ANTARES_GLOBAL std::mutex modplug_mutex;
+
+// Call with `modplug_mutex` held.
+static File load(pn::data_view in) {
     ModPlug_Settings settings;
     ModPlug_GetSettings(&settings);
     settings.mFlags            = MODPLUG_ENABLE_OVERSAMPLING;
-    settings.mChannels         = 2;
+    settings.mChannels         = kChannels;
     settings.mBits             = 16;
-    settings.mFrequency        = 44100;
+    settings.mFrequency        = kFrequency;
     settings.mStereoSeparation = 128;
     settings.mResamplingMode   = MODPLUG_RESAMPLE_NEAREST;  // "Low" quality, but matches original game's behavior and makes most instruments sound sharper
     ModPlug_SetSettings(&settings);
-    std::unique_ptr<::ModPlugFile, decltype(&ModPlug_Unload)> file(
-            ModPlug_Load(in.data(), in.size()), ModPlug_Unload);
+    return File(ModPlug_Load(in.data(), in.size()), ModPlug_Unload);
+}
+
+SoundData convert(pn::data_view in) {
+    std::unique_lock<std::mutex> lock(modplug_mutex);
+    File                         file = load(in);
+    if (!file) {
+        throw std::runtime_error("couldn't load module");
+    }
 
+    // ModPlug gives the length in milliseconds. Render into a buffer with a second to spare,
+    // which is rarely outgrown, then trim it to what was rendered.
+    const int frame_size = sizeof(int16_t) * kChannels;
+    int64_t   frames     = (ModPlug_GetLength(file.get()) + 1000) * int64_t{kFrequency} / 1000;
     SoundData s;
-    s.channels  = 2;
-    s.frequency = 44100;
-    uint8_t buffer[1024];
-    pn::data_view::size_type read;
-    do {
-        read = ModPlug_Read(file.get(), buffer, 1024);
-        s.data += pn::data_view(buffer, read);
-    } while (read > 0);
+    s.channels  = kChannels;
+    s.frequency = kFrequency;
+    s.data.resize(frames * frame_size);
+    int size = 0;
+    while (int read = ModPlug_Read(file.get(), s.data.data() + size, s.data.size() - size)) {
+        size += read;
+        if (size == s.data.size()) {
+            s.data.resize(s.data.size() * 2);
+        }
+    }
+    s.data.resize(size);
     return s;
 }
 
+namespace {
+
+// ModPlug copies the module when loading it, so the stream doesn't need to keep its input.
+class ModPlugStream : public SoundStream {
+  public:
+    ModPlugStream(pn::data_view in) : _file(nullptr, ModPlug_Unload) {
+        std::unique_lock<std::mutex> lock(modplug_mutex);
+        _file = load(in);
+        if (!_file) {
+            throw std::runtime_error("couldn't load module");
+        }
+    }
+
+    ~ModPlugStream() {
+        std::unique_lock<std::mutex> lock(modplug_mutex);
+        _file.reset();
+    }
+
+    int channels() const override { return kChannels; }
+    int frequency() const override { return kFrequency; }
+
+    int read(uint8_t* data, int size) override {
+        size -= size % (sizeof(int16_t) * kChannels);
+        std::unique_lock<std::mutex> lock(modplug_mutex);
+        return ModPlug_Read(_file.get(), data, size);
+    }
+
+    void rewind() override {
+        std::unique_lock<std::mutex> lock(modplug_mutex);
+        ModPlug_Seek(_file.get(), 0);
+    }
+
+  private:
+    File _file;
+};
+
+}  // namespace
+
+std::unique_ptr<SoundStream> stream(pn::data in) {
+    return std::unique_ptr<SoundStream>(new ModPlugStream(in));
+}
+
 }  // namespace modplug
 
 }  // namespace antares
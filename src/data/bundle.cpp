@@ -0,0 +1,230 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2008-2017 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include "data/bundle.hpp"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <limits>
+
+#if defined(_WIN32) && !defined(__LITTLE_ENDIAN__)
+#define __LITTLE_ENDIAN__ 1
+#endif
+
+namespace antares {
+
+static const uint8_t kBundleMagic[8] = {'a', 'n', 't', 'a', 'r', 'e', 's', 0x01};
+
+namespace {
+
+// Reads big-endian integers and byte ranges in place, checking each read against the end of the
+// data.
+class HeaderReader {
+  public:
+    HeaderReader(pn::data_view data) : _data(data), _pos(0) {}
+
+    const uint8_t* bytes(uint64_t size) {
+        if (size > _data.size() - _pos) {
+            throw std::runtime_error("truncated data");
+        }
+        const uint8_t* p = _data.data() + _pos;
+        _pos += size;
+        return p;
+    }
+
+    uint64_t integer(int size) {
+        const uint8_t* p = bytes(size);
+        uint64_t       x = 0;
+        for (int i = 0; i < size; ++i) {
+            x = (x << 8) | p[i];
+        }
+        return x;
+    }
+
+  private:
+    pn::data_view _data;
+    uint64_t      _pos;
+};
+
+}  // namespace
+
+static void write_integer(pn::output_view out, uint64_t x, int size) {
+    uint8_t bytes[8];
+    for (int i = size - 1; i >= 0; --i) {
+        bytes[i] = x & 0xff;
+        x >>= 8;
+    }
+    out.write(pn::data_view{bytes, size}).check();
+}
+
+static void write_file(FILE* f, pn::string_view path, pn::data_view data) {
+    if (fwrite(data.data(), 1, data.size(), f) != static_cast<size_t>(data.size())) {
+        throw std::runtime_error(pn::format("{0}: {1}", path, strerror(errno)).c_str());
+    }
+}
+
+bool PluginBundle::is_bundle(pn::string_view path) {
+    FILE* f = fopen(path.copy().c_str(), "rb");
+    if (!f) {
+        return false;
+    }
+    uint8_t magic[sizeof(kBundleMagic)];
+    bool    ok = (fread(magic, 1, sizeof(magic), f) == sizeof(magic)) &&
+              (memcmp(magic, kBundleMagic, sizeof(kBundleMagic)) == 0);
+    fclose(f);
+    return ok;
+}
+
+void PluginBundle::write(pn::string_view path, const std::map<pn::string, pn::data>& files) {
+    if (files.size() > 0xffffffffull) {
+        throw std::runtime_error(pn::format("{0}: too many files", path).c_str());
+    }
+    uint64_t header_size = sizeof(kBundleMagic) + 4;
+    for (const auto& kv : files) {
+        header_size += 4 + pn::string_view{kv.first}.size() + 8 + 8;
+    }
+
+    pn::data   header;
+    pn::output out = header.output().check();
+    out.write(pn::data_view{kBundleMagic, sizeof(kBundleMagic)}).check();
+    write_integer(out, files.size(), 4);
+    uint64_t offset = header_size;
+    for (const auto& kv : files) {
+        pn::string_view name = kv.first;
+        write_integer(out, name.size(), 4);
+        out.write(name).check();
+        write_integer(out, offset, 8);
+        write_integer(out, kv.second.size(), 8);
+        offset += kv.second.size();
+    }
+
+    pn::string path_copy = path.copy();
+    FILE*      f         = fopen(path_copy.c_str(), "wb");
+    if (!f) {
+        throw std::runtime_error(pn::format("{0}: {1}", path, strerror(errno)).c_str());
+    }
+    try {
+        write_file(f, path, header);
+        for (const auto& kv : files) {
+            write_file(f, path, kv.second);
+        }
+    } catch (...) {
+        fclose(f);
+        remove(path_copy.c_str());
+        throw;
+    }
+    if (fclose(f) != 0) {
+        int error = errno;
+        remove(path_copy.c_str());
+        throw std::runtime_error(pn::format("{0}: {1}", path, strerror(error)).c_str());
+    }
+}
+
+PluginBundle::PluginBundle(pn::string_view path) : _path(path.copy()), _file(path) {
+    HeaderReader in(_file.data());
+    if (memcmp(in.bytes(sizeof(kBundleMagic)), kBundleMagic, sizeof(kBundleMagic)) != 0) {
+        throw std::runtime_error(pn::format("{0}: not a plugin bundle", path).c_str());
+    }
+    const uint64_t max_size = std::numeric_limits<int>::max();
+    uint64_t       count    = in.integer(4);
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t    path_size = in.integer(4);
+        const char* data      = reinterpret_cast<const char*>(in.bytes(path_size));
+        uint64_t    offset    = in.integer(8);
+        uint64_t    size      = in.integer(8);
+        if ((path_size > max_size) || (size > max_size)) {
+            throw std::runtime_error(pn::format("{0}: entry too large", path).c_str());
+        } else if ((offset > _file.data().size()) || (size > _file.data().size() - offset)) {
+            throw std::runtime_error(pn::format("{0}: truncated bundle", path).c_str());
+        }
+        Entry e;
+        e.path = pn::string_view{data, static_cast<int>(path_size)};
+        e.data = pn::data_view{_file.data().data() + offset, static_cast<int>(size)};
+        _entries.push_back(e);
+    }
+}
+
+void write_pix(pn::output_view out, const PixMap& pix) {
+    write_integer(out, pix.size().width, 4);
+    write_integer(out, pix.size().height, 4);
+    for (int y = 0; y < pix.size().height; ++y) {
+        out.write(pn::data_view{reinterpret_cast<const uint8_t*>(pix.row(y)),
+                                static_cast<int>(pix.size().width * sizeof(RgbColor))})
+                .check();
+    }
+}
+
+// RgbColor is four bytes in the same order as the file, so the pixels are used where they are.
+MappedPixMap::MappedPixMap(pn::data_view in) {
+    HeaderReader r(in);
+    uint64_t     width  = r.integer(4);
+    uint64_t     height = r.integer(4);
+    if ((height > 0) && (width > (in.size() - 8) / sizeof(RgbColor) / height)) {
+        throw std::runtime_error("truncated image");
+    }
+    _size  = Size{static_cast<int32_t>(width), static_cast<int32_t>(height)};
+    _bytes = reinterpret_cast<const RgbColor*>(r.bytes(width * height * sizeof(RgbColor)));
+}
+
+const Size&     MappedPixMap::size() const { return _size; }
+const RgbColor* MappedPixMap::bytes() const { return _bytes; }
+int             MappedPixMap::row_bytes() const { return _size.width; }
+
+RgbColor* MappedPixMap::mutable_bytes() { throw std::runtime_error("pixels are read-only"); }
+
+MappedPixMap read_pix(pn::data_view in) { return MappedPixMap(in); }
+
+void write_pcm(pn::output_view out, const SoundData& sound) {
+    write_integer(out, sound.channels, 4);
+    write_integer(out, sound.frequency, 4);
+    pn::data_view in = sound.samples();
+    pn::data      samples;
+    samples.resize(in.size() & ~1);
+    for (int i = 0; i < samples.size(); i += 2) {
+        int16_t x;
+        memcpy(&x, in.data() + i, sizeof(x));
+        samples.data()[i]     = static_cast<uint16_t>(x) & 0xff;
+        samples.data()[i + 1] = static_cast<uint16_t>(x) >> 8;
+    }
+    out.write(samples).check();
+}
+
+SoundData read_pcm(pn::data_view in) {
+    HeaderReader r(in);
+    SoundData    s;
+    s.channels  = r.integer(4);
+    s.frequency = r.integer(4);
+    int            size    = (in.size() - 8) & ~1;
+    const uint8_t* samples = r.bytes(size);
+#if defined(__LITTLE_ENDIAN__)
+    s.in_place = pn::data_view{samples, size};
+#elif defined(__BIG_ENDIAN__)
+    s.data.resize(size);
+    for (int i = 0; i < size; i += 2) {
+        s.data.data()[i]     = samples[i + 1];
+        s.data.data()[i + 1] = samples[i];
+    }
+#else
+#error "Couldn't determine endianness of platform"
+#endif
+    return s;
+}
+
+}  // namespace antares
@@ -69,9 +69,17 @@ const Level* Level::get(pn::string_view name) {
     auto it = plug.levels.find(name.copy());
     if (it == plug.levels.end()) {
         return nullptr;
-    } else {
-        return &it->second;
+    } else if (!it->second.level) {
+        std::unique_ptr<Level> l(new Level(Resource::level(name)));
+        if (l->base.chapter.has_value() != it->second.chapter.has_value() ||
+            (l->base.chapter.has_value() && (*l->base.chapter != *it->second.chapter))) {
+            throw std::runtime_error(
+                    pn::format("levels/{0}.pn: chapter changed since it was cataloged", name)
+                            .c_str());
+        }
+        it->second.level = std::move(l);
     }
+    return it->second.level.get();
 }
 
 FIELD_READER(LevelBase::PlayerType) {
@@ -26,6 +26,7 @@
 #include "config/dirs.hpp"
 #include "config/preferences.hpp"
 #include "data/base-object.hpp"
+#include "data/bundle.hpp"
 #include "data/condition.hpp"
 #include "data/field.hpp"
 #include "data/initial.hpp"
@@ -53,30 +54,35 @@ static void read_all_levels() {
     plug.levels.clear();
     plug.chapters.clear();
     for (pn::string_view name : Resource::list_levels()) {
-        auto it = plug.levels.emplace(name.copy(), Resource::level(name)).first;
-        if (it->second.base.chapter.has_value()) {
-            auto chapter = *it->second.base.chapter;
-            if (plug.chapters.find(chapter) != plug.chapters.end()) {
+        sfz::optional<int64_t> chapter = Resource::level_chapter(name);
+        plug.levels.emplace(name.copy(), CatalogedLevel{chapter, nullptr});
+        if (chapter.has_value()) {
+            if (plug.chapters.find(*chapter) != plug.chapters.end()) {
                 throw std::runtime_error(pn::format(
                                                  "duplicate chapter {} in levels {} and {}",
-                                                 chapter, plug.chapters[chapter], name)
+                                                 *chapter, plug.chapters[*chapter], name)
                                                  .c_str());
             }
-            plug.chapters[chapter] = name.copy();
+            plug.chapters[*chapter] = name.copy();
         }
     }
 }
 
 void PluginInit(sfz::optional<pn::string_view> path) {
-    plug.dir = sfz::nullopt;
-    plug.zip = nullptr;
+    plug.dir    = sfz::nullopt;
+    plug.zip    = nullptr;
+    plug.bundle = nullptr;
     if (path.has_value()) {
         if (path::isdir(*path)) {
             plug.dir.emplace(path->copy());
+        } else if (PluginBundle::is_bundle(*path)) {
+            plug.bundle.reset(new PluginBundle(*path));
         } else {
             plug.zip.reset(new zipxx::ZipArchive(*path, 0));
         }
     }
+    Resource::reindex();
+    Resource::clear_templates();
 
     plug.info = Resource::info();
     try {
@@ -93,18 +99,55 @@ void PluginInit(sfz::optional<pn::string_view> path) {
     read_all_levels();
 }
 
-void load_race(const NamedHandle<const Race>& r) {
-    if (plug.races.find(r.name().copy()) != plug.races.end()) {
-        return;  // already loaded.
+template <typename T>
+static bool unchanged(const Loaded<T>& l) {
+    try {
+        return Resource::digest(l.sources) == l.digest;
+    } catch (...) {
+        return false;  // a source is gone; parse again to get the real error.
+    }
+}
+
+// Marks `name` loaded in `cache`. If it was parsed for an earlier level and its sources are
+// unchanged, that's all; otherwise it's parsed by `parse`.
+template <typename T, typename Parse>
+static void load_cached(
+        std::map<pn::string, Loaded<T>>* cache, pn::string_view name, Parse parse) {
+    auto it = cache->find(name.copy());
+    if (it != cache->end()) {
+        if (it->second.loaded) {
+            return;  // already loaded.
+        } else if (unchanged(it->second)) {
+            it->second.loaded = true;
+            return;
+        }
+        cache->erase(it);
     }
-    plug.races.emplace(r.name().copy(), Resource::race(r.name()));
+
+    Resource::Sources sources;
+    T                 value  = parse(name, &sources);
+    uint64_t          digest = Resource::digest(sources);
+    cache->emplace(name.copy(), Loaded<T>{std::move(value), std::move(sources), digest, true});
+}
+
+void load_race(const NamedHandle<const Race>& r) {
+    load_cached(&plug.races, r.name(), Resource::race);
 }
 
 void load_object(const NamedHandle<const BaseObject>& o) {
-    if (plug.objects.find(o.name().copy()) != plug.objects.end()) {
-        return;  // already loaded.
+    load_cached(&plug.objects, o.name(), Resource::object);
+}
+
+void unload_races() {
+    for (auto& kv : plug.races) {
+        kv.second.loaded = false;
+    }
+}
+
+void unload_objects() {
+    for (auto& kv : plug.objects) {
+        kv.second.loaded = false;
     }
-    plug.objects.emplace(o.name().copy(), Resource::object(o.name()));
 }
 
 }  // namespace antares
@@ -29,7 +29,13 @@ using std::unique_ptr;
 
 namespace antares {
 
-Race* Race::get(pn::string_view name) { return &plug.races[name.copy()]; }
+Race* Race::get(pn::string_view name) {
+    auto it = plug.races.find(name.copy());
+    if ((it != plug.races.end()) && it->second.loaded) {
+        return &it->second.value;
+    }
+    return nullptr;
+}
 
 Race race(path_value x) {
     return required_struct<Race>(
@@ -19,16 +19,22 @@
 #include "data/resource.hpp"
 
 #include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
 
 #include <array>
+#include <deque>
+#include <map>
 #include <pn/input>
 #include <sfz/sfz.hpp>
+#include <unordered_map>
 #include <zipxx/zipxx.hpp>
 
 #include "config/dirs.hpp"
 #include "config/preferences.hpp"
 #include "data/audio.hpp"
 #include "data/base-object.hpp"
+#include "data/bundle.hpp"
 #include "data/briefing.hpp"
 #include "data/condition.hpp"
 #include "data/field.hpp"
@@ -43,6 +49,9 @@
 #include "data/sprite-data.hpp"
 #include "drawing/text.hpp"
 #include "game/sys.hpp"
+#include "lang/defines.hpp"
+#include "lang/fnv.hpp"
+#include "math/rotation.hpp"
 #include "video/driver.hpp"
 
 namespace path = sfz::path;
@@ -82,19 +91,122 @@ class ResourceLister : public sfz::TreeWalker {
     std::vector<pn::string>* const _names;
 };
 
+enum class ResourceSource {
+    PLUGIN_DIR,
+    PLUGIN_ZIP,
+    PLUGIN_BUNDLE,
+    FACTORY_SCENARIO,
+    APPLICATION,
+};
+
+struct ResourceLocation {
+    ResourceSource source;
+    int64_t        index;  // Of the entry, if source is PLUGIN_ZIP or PLUGIN_BUNDLE.
+};
+
+// Maps the path of each resource to where it will be read from, so that finding a resource
+// doesn't need to probe the filesystem. Built by PluginInit(), or by the first lookup if that
+// comes earlier. Files added after it's built aren't found until it's built again.
+//
+// `locations` refers to the strings in `paths`, which is a deque so that they don't move, and so
+// lookups don't need to copy the path they're given.
+struct ResourceIndex {
+    bool                                                            built = false;
+    std::deque<pn::string>                                          paths;
+    std::unordered_map<pn::string_view, ResourceLocation, FnvHash> locations;
+
+    // Earlier sources take precedence, so a resource that's already indexed is left alone.
+    void add(pn::string path, ResourceLocation location) {
+        if (locations.find(path) != locations.end()) {
+            return;
+        }
+        paths.push_back(std::move(path));
+        locations.emplace(paths.back(), location);
+    }
+};
+static ANTARES_GLOBAL ResourceIndex resource_index;
+
+// The digest of each source that has been hashed, with the size and modification time of the
+// file it was read from. Zip and bundle entries can't change until the plugin is reindexed, so
+// they have no stamp (-1); files in a directory are hashed again only if their stamp changes.
+struct SourceDigest {
+    int64_t  size;
+    int64_t  mtime;
+    uint64_t digest;
+};
+static ANTARES_GLOBAL std::map<pn::string, SourceDigest> source_digests;
+
+pn::string_view resource_root(ResourceSource source) {
+    switch (source) {
+        case ResourceSource::PLUGIN_DIR: return *plug.dir;
+        case ResourceSource::PLUGIN_ZIP: return plug.zip->path();
+        case ResourceSource::PLUGIN_BUNDLE: return plug.bundle->path();
+        case ResourceSource::FACTORY_SCENARIO: return factory_scenario_path();
+        case ResourceSource::APPLICATION: return application_path();
+    }
+}
+
+void index_dir(pn::string_view dir, ResourceSource source) {
+    if (!path::isdir(dir)) {
+        return;
+    }
+    // Follow symlinks, so that linked files and directories are found, as they would be by
+    // probing the filesystem for each resource.
+    std::vector<pn::string> paths;
+    sfz::walk(dir, sfz::WALK_LOGICAL, ResourceLister(dir, "", &paths));
+    for (pn::string& p : paths) {
+        resource_index.add(std::move(p), ResourceLocation{source, -1});
+    }
+}
+
+void index_zip(const zipxx::ZipArchive& zip) {
+    for (auto i : sfz::range(zip.size())) {
+        resource_index.add(
+                zip.name(i).copy(),
+                ResourceLocation{ResourceSource::PLUGIN_ZIP, static_cast<int64_t>(i)});
+    }
+}
+
+void index_bundle(const PluginBundle& bundle) {
+    for (auto i : sfz::range(bundle.entries().size())) {
+        resource_index.add(
+                bundle.entries()[i].path.copy(),
+                ResourceLocation{ResourceSource::PLUGIN_BUNDLE, static_cast<int64_t>(i)});
+    }
+}
+
+const ResourceLocation* locate(pn::string_view resource_path) {
+    if (!resource_index.built) {
+        Resource::reindex();
+    }
+    auto it = resource_index.locations.find(resource_path);
+    if (it == resource_index.locations.end()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+// Bundle entries are read in place, whether they hold text or binary data.
+pn::string_view as_string(pn::data_view data) {
+    return pn::string_view{reinterpret_cast<const char*>(data.data()), data.size()};
+}
+
+[[noreturn]] void throw_not_found(pn::string_view resource_path) {
+    throw std::runtime_error(
+            pn::format("couldn't find resource {0}", pn::dump(resource_path, pn::dump_short))
+                    .c_str());
+}
+
 class TextResourceData {
   public:
     static TextResourceData load(pn::string_view resource_path) {
-        TextResourceData data;
-        if ((plug.dir.has_value() && data.load(*plug.dir, resource_path)) ||
-            (plug.zip && data.load(*plug.zip, resource_path)) ||
-            data.load(factory_scenario_path(), resource_path) ||
-            data.load(application_path(), resource_path)) {
-            return data;
+        const ResourceLocation* location = locate(resource_path);
+        if (!location) {
+            throw_not_found(resource_path);
         }
-        throw std::runtime_error(
-                pn::format("couldn't find resource {0}", pn::dump(resource_path, pn::dump_short))
-                        .c_str());
+        TextResourceData data;
+        data.load(*location, resource_path);
+        return data;
     }
 
     static TextResourceData load_info() {
@@ -109,6 +221,11 @@ class TextResourceData {
                 throw std::runtime_error(
                         pn::format("{}: not an antares plugin", plug.zip->path()).c_str());
             }
+        } else if (plug.bundle) {
+            if (!data.load(*plug.bundle, "info.pn")) {
+                throw std::runtime_error(
+                        pn::format("{}: not an antares plugin", plug.bundle->path()).c_str());
+            }
         } else {
             if (!data.load(application_path(), "info.pn")) {
                 throw std::runtime_error("missing application data");
@@ -128,6 +245,18 @@ class TextResourceData {
     pn::input_view input() const { return _input; }
 
   private:
+    void load(const ResourceLocation& location, pn::string_view resource_path) {
+        if (location.source == ResourceSource::PLUGIN_ZIP) {
+            _zip_file.reset(new zipxx::ZipFileReader(*plug.zip, location.index));
+            _input = _zip_file->string().input();
+        } else if (location.source == ResourceSource::PLUGIN_BUNDLE) {
+            _input = as_string(plug.bundle->entries()[location.index].data).input();
+        } else {
+            pn::string path = pn::format("{0}/{1}", resource_root(location.source), resource_path);
+            _input          = pn::input{path, pn::text};
+        }
+    }
+
     bool load(pn::string_view dir, pn::string_view resource_path) {
         pn::string path = pn::format("{0}/{1}", dir, resource_path);
         if (!path::isfile(path)) {
@@ -147,6 +276,16 @@ class TextResourceData {
         return true;
     }
 
+    bool load(const PluginBundle& bundle, pn::string_view resource_path) {
+        for (const PluginBundle::Entry& e : bundle.entries()) {
+            if (e.path == resource_path) {
+                _input = as_string(e.data).input();
+                return true;
+            }
+        }
+        return false;
+    }
+
     std::unique_ptr<zipxx::ZipFileReader> _zip_file;
     pn::input                             _input;
 };
@@ -154,65 +293,48 @@ class TextResourceData {
 class BinaryResourceData {
   public:
     static BinaryResourceData load(pn::string_view resource_path) {
-        BinaryResourceData data;
-        if ((plug.dir.has_value() && data.load(*plug.dir, resource_path)) ||
-            (plug.zip && data.load(*plug.zip, resource_path)) ||
-            data.load(factory_scenario_path(), resource_path) ||
-            data.load(application_path(), resource_path)) {
-            return data;
+        const ResourceLocation* location = locate(resource_path);
+        if (!location) {
+            throw_not_found(resource_path);
         }
-        throw std::runtime_error(
-                pn::format("couldn't find resource {0}", pn::dump(resource_path, pn::dump_short))
-                        .c_str());
+        BinaryResourceData data;
+        data.load(*location, resource_path);
+        return data;
     }
 
-    pn::data data() {
-        pn::data d;
-        if (_input.read(pn::all(d)).error()) {
-            throw std::runtime_error("read error");
-        }
-        return d;
-    }
+    // The resource's contents, valid as long as this object is. Zip entries are inflated once,
+    // into the reader's buffer; bundle entries and plain files are mapped, not copied.
+    pn::data_view data() const { return _data; }
+
+    // Whether data() stays valid after this object is gone. It does for bundle entries, which
+    // are mapped for as long as the plugin is loaded.
+    bool persistent() const { return !_zip_file && !_file; }
 
     pn::input_view input() const { return _input; }
 
   private:
-    bool load(pn::string_view dir, pn::string_view resource_path) {
-        pn::string path = pn::format("{0}/{1}", dir, resource_path);
-        if (!path::isfile(path)) {
-            return false;
-        }
-        _input = pn::input{path, pn::binary};
-        return true;
-    }
-
-    bool load(const zipxx::ZipArchive& zip, pn::string_view resource_path) {
-        auto index = zip.locate(resource_path.copy().c_str());
-        if (index < 0) {
-            return false;
+    void load(const ResourceLocation& location, pn::string_view resource_path) {
+        if (location.source == ResourceSource::PLUGIN_ZIP) {
+            _zip_file.reset(new zipxx::ZipFileReader(*plug.zip, location.index));
+            _data = _zip_file->data();
+        } else if (location.source == ResourceSource::PLUGIN_BUNDLE) {
+            _data = plug.bundle->entries()[location.index].data;
+        } else {
+            pn::string path = pn::format("{0}/{1}", resource_root(location.source), resource_path);
+            _file.reset(new sfz::mapped_file(path));
+            _data = _file->data();
         }
-        _zip_file.reset(new zipxx::ZipFileReader(zip, index));
-        _input = _zip_file->data().input();
-        return true;
+        _input = _data.input();
     }
 
     std::unique_ptr<zipxx::ZipFileReader> _zip_file;
+    std::unique_ptr<sfz::mapped_file>     _file;
+    pn::data_view                         _data;
     pn::input                             _input;
 };
 
-static bool resource_exists_in_dir(pn::string_view dir, pn::string_view resource_path) {
-    return path::isfile(pn::format("{0}/{1}", dir, resource_path));
-}
-
-static bool resource_exists_in_zip(const zipxx::ZipArchive& zip, pn::string_view resource_path) {
-    return zip.locate(resource_path.copy().c_str()) != zip.npos;
-}
-
 static bool resource_exists(pn::string_view resource_path) {
-    return (plug.dir.has_value() && resource_exists_in_dir(*plug.dir, resource_path)) ||
-           (plug.zip && resource_exists_in_zip(*plug.zip, resource_path)) ||
-           resource_exists_in_dir(factory_scenario_path(), resource_path) ||
-           resource_exists_in_dir(application_path(), resource_path);
+    return locate(resource_path) != nullptr;
 }
 
 static bool startswith(pn::string_view s, pn::string_view prefix) {
@@ -242,6 +364,16 @@ static std::vector<pn::string> list_resources(pn::string_view dir, pn::string_vi
                                 .copy());
             }
         }
+    } else if (plug.bundle) {
+        pn::string prefix = pn::format("{0}/", dir);
+        for (const PluginBundle::Entry& e : plug.bundle->entries()) {
+            pn::string_view name = e.path;
+            if (startswith(name, prefix) && endswith(name, extension)) {
+                resources.push_back(
+                        name.substr(prefix.size(), name.size() - prefix.size() - extension.size())
+                                .copy());
+            }
+        }
     } else {
         pn::string path = pn::format("{0}/{1}", application_path(), dir);
         if (sfz::path::isdir(path)) {
@@ -251,7 +383,29 @@ static std::vector<pn::string> list_resources(pn::string_view dir, pn::string_vi
     return resources;
 }
 
+void Resource::reindex() {
+    resource_index.locations.clear();
+    resource_index.paths.clear();
+    source_digests.clear();
+    if (plug.dir.has_value()) {
+        index_dir(*plug.dir, ResourceSource::PLUGIN_DIR);
+    }
+    if (plug.zip) {
+        index_zip(*plug.zip);
+    }
+    if (plug.bundle) {
+        index_bundle(*plug.bundle);
+    }
+    index_dir(factory_scenario_path(), ResourceSource::FACTORY_SCENARIO);
+    index_dir(application_path(), ResourceSource::APPLICATION);
+    resource_index.built = true;
+}
+
+bool Resource::thread_safe() { return !plug.zip; }
+
 std::vector<pn::string> Resource::list_levels() { return list_resources("levels", ".pn"); }
+std::vector<pn::string> Resource::list_objects() { return list_resources("objects", ".pn"); }
+std::vector<pn::string> Resource::list_races() { return list_resources("races", ".pn"); }
 std::vector<pn::string> Resource::list_replays() { return list_resources("replays", ".NLRP"); }
 
 static pn::value procyon(pn::string_view path) {
@@ -290,7 +444,7 @@ static Texture load_hidpi_texture(pn::string_view name) {
             continue;
         }
         try {
-            ArrayPixMap pix = read_png(BinaryResourceData::load(path).input());
+            ArrayPixMap pix = read_png(BinaryResourceData::load(path).data());
             return sys.video->texture(pn::format("/{0}", path), pix, scale);
         } catch (...) {
             std::throw_with_nested(std::runtime_error(path.c_str()));
@@ -305,6 +459,7 @@ static SoundData load_audio(pn::string_view name) {
         const char ext[6];
         SoundData (*fn)(pn::data_view);
     } fmts[] = {
+            {".pcm", read_pcm},  // decoded by build-plugin
             {".aiff", sndfile::convert},
             {".s3m", modplug::convert},
             {".xm", modplug::convert},
@@ -316,7 +471,38 @@ static SoundData load_audio(pn::string_view name) {
             continue;
         }
         try {
-            return fmt.fn(BinaryResourceData::load(path).data());
+            auto      rsrc = BinaryResourceData::load(path);
+            SoundData s    = fmt.fn(rsrc.data());
+            if (!rsrc.persistent() && !s.data.size()) {
+                s.data = s.in_place.copy();  // read in place, but from data that's going away.
+            }
+            return s;
+        } catch (...) {
+            std::throw_with_nested(std::runtime_error(path.c_str()));
+        }
+    }
+    throw std::runtime_error(
+            pn::format("couldn't find sound {0}", pn::dump(name, pn::dump_short)).c_str());
+}
+
+// Like load_audio(), but keeps only the encoded file in memory, and decodes it as it's read.
+static std::unique_ptr<SoundStream> open_audio_stream(pn::string_view name) {
+    static const struct {
+        const char ext[6];
+        std::unique_ptr<SoundStream> (*fn)(pn::data);
+    } fmts[] = {
+            {".aiff", sndfile::stream},
+            {".s3m", modplug::stream},
+            {".xm", modplug::stream},
+    };
+
+    for (const auto& fmt : fmts) {
+        pn::string path = pn::format("{0}{1}", name, fmt.ext);
+        if (!resource_exists(path)) {
+            continue;
+        }
+        try {
+            return fmt.fn(BinaryResourceData::load(path).data().copy());
         } catch (...) {
             std::throw_with_nested(std::runtime_error(path.c_str()));
         }
@@ -329,6 +515,42 @@ bool Resource::object_exists(pn::string_view name) {
     return resource_exists(pn::format("objects/{0}.pn", name));
 }
 
+static uint64_t source_digest(pn::string_view resource_path) {
+    const ResourceLocation* location = locate(resource_path);
+    if (!location) {
+        throw_not_found(resource_path);
+    }
+    int64_t size = -1, mtime = -1;
+    if ((location->source != ResourceSource::PLUGIN_ZIP) &&
+        (location->source != ResourceSource::PLUGIN_BUNDLE)) {
+        pn::string  path = pn::format("{0}/{1}", resource_root(location->source), resource_path);
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) {
+            throw_not_found(resource_path);
+        }
+        size  = st.st_size;
+        mtime = st.st_mtime;
+    }
+
+    auto it = source_digests.find(resource_path.copy());
+    if ((it != source_digests.end()) && (it->second.size == size) && (it->second.mtime == mtime)) {
+        return it->second.digest;
+    }
+    uint64_t digest = fnv(kFnvBasis, BinaryResourceData::load(resource_path).data());
+    source_digests[resource_path.copy()] = SourceDigest{size, mtime, digest};
+    return digest;
+}
+
+// FNV-1a over the digests of each source, in order. Throws if a source no longer exists.
+uint64_t Resource::digest(const Sources& sources) {
+    uint64_t h = kFnvBasis;
+    for (const pn::string& path : sources) {
+        uint64_t d = source_digest(path);
+        h          = fnv(h, reinterpret_cast<const uint8_t*>(&d), sizeof(d));
+    }
+    return h;
+}
+
 FontData Resource::font(pn::string_view name) {
     pn::string path = pn::format("fonts/{0}.pn", name);
     try {
@@ -362,46 +584,143 @@ Level Resource::level(pn::string_view name) {
     }
 }
 
+// Scans a level's top-level lines for its chapter, so that levels can be cataloged without
+// being parsed. If the chapter isn't written as a plain integer, parses the level after all.
+sfz::optional<int64_t> Resource::level_chapter(pn::string_view name) {
+    pn::string path = pn::format("levels/{0}.pn", name);
+    pn::string text;
+    try {
+        text = TextResourceData::load(path).string();
+    } catch (...) {
+        std::throw_with_nested(std::runtime_error(path.c_str()));
+    }
+
+    static const char kKey[]   = "chapter:";
+    const int         kKeySize = sizeof(kKey) - 1;
+    pn::string_view   s        = text;
+    for (int line = 0; line < s.size();) {
+        int end = line;
+        while ((end < s.size()) && (s.data()[end] != '\n')) {
+            ++end;
+        }
+        if ((end - line >= kKeySize) && (memcmp(s.data() + line, kKey, kKeySize) == 0)) {
+            int  i        = line + kKeySize;
+            auto is_space = [&s, &i] { return (s.data()[i] == ' ') || (s.data()[i] == '\t'); };
+            while ((i < end) && is_space()) {
+                ++i;
+            }
+            bool negative = (i < end) && (s.data()[i] == '-');
+            i += negative;
+            int64_t chapter = 0;
+            int     digits  = 0;
+            while ((i < end) && (digits < 18) && (s.data()[i] >= '0') && (s.data()[i] <= '9')) {
+                chapter = (chapter * 10) + (s.data()[i++] - '0');
+                ++digits;
+            }
+            while ((i < end) && (is_space() || (s.data()[i] == '\r'))) {
+                ++i;
+            }
+            if ((digits > 0) && ((i == end) || (s.data()[i] == '#'))) {
+                return sfz::make_optional(negative ? -chapter : chapter);
+            }
+            return level(name).base.chapter;
+        }
+        line = end + 1;
+    }
+    return sfz::nullopt;
+}
+
 SoundData Resource::music(pn::string_view name) {
     return load_audio(pn::format("music/{0}", name));
 }
 
-static void merge_value(pn::value_ref base, pn::value_cref patch) {
-    switch (patch.type()) {
-        case PN_NULL:
-        case PN_BOOL:
-        case PN_INT:
-        case PN_FLOAT:
-        case PN_DATA:
-        case PN_STRING:
-        case PN_ARRAY: base = patch.copy(); return;
+std::unique_ptr<SoundStream> Resource::music_stream(pn::string_view name) {
+    return open_audio_stream(pn::format("music/{0}", name));
+}
 
-        case PN_MAP: break;
+// Returns `patch` merged onto `base`. Maps are merged key by key, and anything else in `patch`
+// replaces what is in `base`. `base` is left as it is, so that a memoized template can be shared
+// by every object that uses it: only the parts of it that `patch` doesn’t replace are copied, and
+// values in `patch` are moved, not copied.
+static pn::value merge_value(pn::value_cref base, pn::value patch) {
+    if (!patch.is_map() || !base.is_map()) {
+        return patch;
     }
-    pn::map_ref m = base.to_map();
-    for (pn::key_value_cref kv : patch.as_map()) {
-        pn::string_view k = kv.key();
-        if (m.has(k)) {
-            pn::value v = m.get(k).copy();
-            merge_value(v, patch.as_map().get(k));
-            m.set(k, std::move(v));
+    pn::value   result;
+    pn::map_ref r = result.to_map();
+    pn::map_ref p = patch.to_map();
+    for (pn::key_value_cref kv : base.as_map()) {
+        pn::value v;
+        if (p.pop(kv.key(), &v)) {
+            r.set(kv.key(), merge_value(kv.value(), std::move(v)));
         } else {
-            m.set(k, kv.value().copy());
+            r.set(kv.key(), kv.value().copy());
         }
     }
+    std::vector<pn::string> keys;
+    for (pn::key_value_cref kv : patch.as_map()) {
+        keys.push_back(kv.key().copy());
+    }
+    for (const pn::string& k : keys) {
+        pn::value v;
+        p.pop(k, &v);
+        r.set(k, std::move(v));
+    }
+    return result;
+}
+
+// Templates are shared by many objects (every weapon of a race, every ship of a class), so once
+// one has been resolved, it's kept for as long as its sources are unchanged. Objects that use it
+// read it in place, and copy only the parts that they don't override.
+struct MergedTemplate {
+    pn::value         value;
+    Resource::Sources sources;
+    uint64_t          digest;
+};
+static ANTARES_GLOBAL std::map<pn::string, MergedTemplate> merged_templates;
+
+static bool unchanged(const MergedTemplate& t) {
+    try {
+        return Resource::digest(t.sources) == t.digest;
+    } catch (...) {
+        return false;  // a source is gone; merge again to get the real error.
+    }
 }
 
-static pn::value merged_object(pn::string_view name) {
+static pn::value merged_object(pn::string_view name, Resource::Sources* sources);
+
+static const pn::value& merged_template(pn::string_view name, Resource::Sources* sources) {
+    auto it = merged_templates.find(name.copy());
+    if ((it != merged_templates.end()) && !unchanged(it->second)) {
+        merged_templates.erase(it);
+        it = merged_templates.end();
+    }
+    if (it == merged_templates.end()) {
+        MergedTemplate t;
+        t.value  = merged_object(name, &t.sources);
+        t.digest = Resource::digest(t.sources);
+        it       = merged_templates.emplace(name.copy(), std::move(t)).first;
+    }
+    if (sources) {
+        for (const pn::string& path : it->second.sources) {
+            sources->push_back(path.copy());
+        }
+    }
+    return it->second.value;
+}
+
+static pn::value merged_object(pn::string_view name, Resource::Sources* sources) {
     pn::string path = pn::format("objects/{0}.pn", name);
     try {
         pn::value x = procyon(path);
+        if (sources) {
+            sources->push_back(path.copy());
+        }
         pn::value tpl;
         if (!x.is_map() || !x.to_map().pop("template", &tpl) || tpl.is_null()) {
             return x;
         } else if (tpl.is_string()) {
-            pn::value base = merged_object(tpl.as_string());
-            merge_value(base, x);
-            return base;
+            return merge_value(merged_template(tpl.as_string(), sources), std::move(x));
         } else {
             throw std::runtime_error("template: must be null or string");
         }
@@ -410,8 +729,10 @@ static pn::value merged_object(pn::string_view name) {
     }
 }
 
-BaseObject Resource::object(pn::string_view name) {
-    pn::value x = merged_object(name);
+void Resource::clear_templates() { merged_templates.clear(); }
+
+BaseObject Resource::object(pn::string_view name, Sources* sources) {
+    pn::value x = merged_object(name, sources);
     try {
         return base_object(x);
     } catch (...) {
@@ -419,10 +740,14 @@ BaseObject Resource::object(pn::string_view name) {
     }
 }
 
-Race Resource::race(pn::string_view name) {
+Race Resource::race(pn::string_view name, Sources* sources) {
     pn::string path = pn::format("races/{0}.pn", name);
     try {
-        return ::antares::race(path_value{procyon(path)});
+        pn::value x = procyon(path);
+        if (sources) {
+            sources->push_back(path.copy());
+        }
+        return ::antares::race(path_value{x});
     } catch (...) {
         std::throw_with_nested(std::runtime_error(path.c_str()));
     }
@@ -443,7 +768,7 @@ std::vector<int32_t> Resource::rotation_table() {
         auto                 rsrc = BinaryResourceData::load(path);
         pn::input_view       in   = rsrc.input();
         std::vector<int32_t> v;
-        v.resize(SystemGlobals::ROT_TABLE_SIZE);
+        v.resize(ROT_TABLE_SIZE);
         for (int32_t& i : v) {
             in.read(&i).check();
         }
@@ -485,22 +810,37 @@ SpriteData Resource::sprite_data(pn::string_view name) {
     }
 }
 
-ArrayPixMap Resource::sprite_image(pn::string_view name) {
-    pn::string path = pn::format("sprites/{0}/image.png", name);
+// Reads "sprites/{name}/{layer}.pix", if build-plugin decoded it, or else the PNG. Pixels from a
+// bundle are read in place; others are copied out of data that's going away.
+static std::unique_ptr<PixMap> sprite_layer(pn::string_view name, pn::string_view layer) {
+    pn::string path    = pn::format("sprites/{0}/{1}.pix", name, layer);
+    bool       decoded = resource_exists(path);
+    if (!decoded) {
+        path = pn::format("sprites/{0}/{1}.png", name, layer);
+    }
     try {
-        return read_png(BinaryResourceData::load(path).input());
+        auto rsrc = BinaryResourceData::load(path);
+        if (!decoded) {
+            return std::unique_ptr<PixMap>(new ArrayPixMap(read_png(rsrc.data())));
+        }
+        MappedPixMap pix = read_pix(rsrc.data());
+        if (rsrc.persistent()) {
+            return std::unique_ptr<PixMap>(new MappedPixMap(pix));
+        }
+        std::unique_ptr<PixMap> copy(new ArrayPixMap(pix.size()));
+        copy->copy(pix);
+        return copy;
     } catch (...) {
         std::throw_with_nested(std::runtime_error(path.c_str()));
     }
 }
 
-ArrayPixMap Resource::sprite_overlay(pn::string_view name) {
-    pn::string path = pn::format("sprites/{0}/overlay.png", name);
-    try {
-        return read_png(BinaryResourceData::load(path).input());
-    } catch (...) {
-        std::throw_with_nested(std::runtime_error(path.c_str()));
-    }
+std::unique_ptr<PixMap> Resource::sprite_image(pn::string_view name) {
+    return sprite_layer(name, "image");
+}
+
+std::unique_ptr<PixMap> Resource::sprite_overlay(pn::string_view name) {
+    return sprite_layer(name, "overlay");
 }
 
 pn::string Resource::text(pn::string_view name) {
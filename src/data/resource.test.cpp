@@ -0,0 +1,122 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2008-2017 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include "data/resource.hpp"
+
+#include <gmock/gmock.h>
+#include <limits.h>
+#include <pn/output>
+#include <sfz/sfz.hpp>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "data/plugin.hpp"
+
+using testing::Eq;
+
+namespace antares {
+namespace {
+
+// Builds a plugin directory in a temporary directory, with some of its resources reached
+// through symlinks, and removes it afterwards.
+class ResourceIndexTest : public testing::Test {
+  public:
+    ResourceIndexTest() {
+        char tmp[PATH_MAX] = "/tmp/antares-resource-test-XXXXXX";
+        _root              = mkdtemp(tmp);
+        _dirs.push_back(_root.copy());
+    }
+
+    ~ResourceIndexTest() {
+        plug.dir = sfz::nullopt;
+        Resource::reindex();
+        for (auto it = _files.rbegin(); it != _files.rend(); ++it) {
+            sfz::unlink(*it);
+        }
+        for (auto it = _dirs.rbegin(); it != _dirs.rend(); ++it) {
+            rmdir(it->c_str());
+        }
+    }
+
+  protected:
+    pn::string path(pn::string_view relpath) { return pn::format("{0}/{1}", _root, relpath); }
+
+    void make_dir(pn::string_view relpath) {
+        sfz::makedirs(path(relpath), 0755);
+        _dirs.push_back(path(relpath));
+    }
+
+    void write_file(pn::string_view relpath, pn::string_view content) {
+        pn::output{path(relpath), pn::text}.write(content).check();
+        _files.push_back(path(relpath));
+    }
+
+    void make_link(pn::string_view target, pn::string_view relpath) {
+        ASSERT_THAT(symlink(path(target).c_str(), path(relpath).c_str()), Eq(0));
+        _files.push_back(path(relpath));
+    }
+
+    void use_plugin(pn::string_view relpath) {
+        plug.dir.emplace(path(relpath));
+        Resource::reindex();
+    }
+
+  private:
+    pn::string              _root;
+    std::vector<pn::string> _dirs;
+    std::vector<pn::string> _files;
+};
+
+TEST_F(ResourceIndexTest, RegularFile) {
+    make_dir("plugin");
+    make_dir("plugin/text");
+    write_file("plugin/text/regular.txt", "regular");
+    use_plugin("plugin");
+    EXPECT_THAT(Resource::text("regular"), Eq("regular"));
+}
+
+TEST_F(ResourceIndexTest, SymlinkedFile) {
+    make_dir("elsewhere");
+    write_file("elsewhere/target.txt", "linked");
+    make_dir("plugin");
+    make_dir("plugin/text");
+    make_link("elsewhere/target.txt", "plugin/text/linked.txt");
+    use_plugin("plugin");
+    EXPECT_THAT(Resource::text("linked"), Eq("linked"));
+}
+
+TEST_F(ResourceIndexTest, SymlinkedDirectory) {
+    make_dir("elsewhere");
+    write_file("elsewhere/inside.txt", "inside");
+    make_dir("plugin");
+    make_link("elsewhere", "plugin/text");
+    use_plugin("plugin");
+    EXPECT_THAT(Resource::text("inside"), Eq("inside"));
+}
+
+TEST_F(ResourceIndexTest, SymlinkedPlugin) {
+    make_dir("elsewhere");
+    make_dir("elsewhere/text");
+    write_file("elsewhere/text/inside.txt", "inside");
+    make_link("elsewhere", "plugin");
+    use_plugin("plugin");
+    EXPECT_THAT(Resource::text("inside"), Eq("inside"));
+}
+
+}  // namespace
+}  // namespace antares
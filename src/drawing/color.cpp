@@ -129,6 +129,12 @@ RgbColor RgbColor::tint(Hue hue, uint8_t shade) {
             ((kDiffuse[h][2] * shade) + kAmbient[h][2]) / 256);
 }
 
+RgbColor::TintCoefficients RgbColor::tint_coefficients(Hue hue) {
+    int h = static_cast<int>(hue);
+    return {{kDiffuse[h][0], kDiffuse[h][1], kDiffuse[h][2]},
+            {kAmbient[h][0], kAmbient[h][1], kAmbient[h][2]}};
+}
+
 const RgbColor& RgbColor::at(uint8_t index) { return kColors[index]; }
 
 pn::string stringify(const RgbColor& color) {
@@ -20,6 +20,7 @@
 
 #include <png.h>
 #include <stdexcept>
+#include <string.h>
 
 namespace antares {
 
@@ -45,32 +46,24 @@ static void png_flush_data(png_struct* png) {
     }
 }
 
-ArrayPixMap read_png(pn::input_view in) {
-    ArrayPixMap pix{0, 0};
-    png_byte    sig[8];
-    if (!(pn_read(in.c_obj(), "$", &sig, static_cast<size_t>(8)) &&
-          (png_sig_cmp(sig, 0, 8) == 0))) {
-        throw std::runtime_error("invalid png signature");
-    }
-
-    png_struct* png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
-    if (!png) {
-        throw std::runtime_error("couldn't create png_struct");
-    }
+// A PNG held in memory, read from front to back.
+struct PngMemory {
+    const uint8_t* data;
+    size_t         size;
+};
 
-    png_info* info = png_create_info_struct(png);
-    if (!info) {
-        png_destroy_read_struct(&png, NULL, NULL);
-        throw std::runtime_error("couldn't create png_info");
-    }
-
-    if (setjmp(png_jmpbuf(png))) {
-        png_destroy_read_struct(&png, &info, NULL);
-        throw std::runtime_error("reading png failed");
+static void png_read_memory(png_struct* png, png_byte* data, png_size_t length) {
+    PngMemory* in = reinterpret_cast<PngMemory*>(png_get_io_ptr(png));
+    if (length > in->size) {
+        png_error(png, "unexpected end of png");
     }
+    memcpy(data, in->data, length);
+    in->data += length;
+    in->size -= length;
+}
 
-    png_set_sig_bytes(png, 8);
-    png_set_read_fn(png, &in, png_read_data);
+// Sets up `png` to produce rows of RgbColor, and returns the size of the image.
+static Size read_png_info(png_struct* png, png_info* info) {
     png_read_info(png, info);
 
     png_uint_32 width;
@@ -78,7 +71,6 @@ ArrayPixMap read_png(pn::input_view in) {
     int         bit_depth;
     int         color_type;
     png_get_IHDR(png, info, &width, &height, &bit_depth, &color_type, NULL, NULL, NULL);
-    pix.resize(Size(width, height));
 
     // We only want to deal with images in 8-bit format.
     if (bit_depth == 16) {
@@ -103,15 +95,108 @@ ArrayPixMap read_png(pn::input_view in) {
         png_set_filler(png, 0xFF, PNG_FILLER_BEFORE);
     }
 
-    // Read in the data, one row at a time.
-    for (size_t i = 0; i < height; ++i) {
+    return Size(width, height);
+}
+
+// Reads in the data, one row at a time.
+static void read_png_rows(png_struct* png, PixMap& pix) {
+    for (int i = 0; i < pix.size().height; ++i) {
         png_read_row(png, reinterpret_cast<uint8_t*>(pix.mutable_row(i)), NULL);
     }
+}
+
+ArrayPixMap read_png(pn::input_view in) {
+    ArrayPixMap pix{0, 0};
+    png_byte    sig[8];
+    if (!(pn_read(in.c_obj(), "$", &sig, static_cast<size_t>(8)) &&
+          (png_sig_cmp(sig, 0, 8) == 0))) {
+        throw std::runtime_error("invalid png signature");
+    }
+
+    png_struct* png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    if (!png) {
+        throw std::runtime_error("couldn't create png_struct");
+    }
+
+    png_info* info = png_create_info_struct(png);
+    if (!info) {
+        png_destroy_read_struct(&png, NULL, NULL);
+        throw std::runtime_error("couldn't create png_info");
+    }
+
+    if (setjmp(png_jmpbuf(png))) {
+        png_destroy_read_struct(&png, &info, NULL);
+        throw std::runtime_error("reading png failed");
+    }
+
+    png_set_sig_bytes(png, 8);
+    png_set_read_fn(png, &in, png_read_data);
+    pix.resize(read_png_info(png, info));
+    read_png_rows(png, pix);
 
     png_destroy_read_struct(&png, &info, NULL);
     return pix;
 }
 
+ArrayPixMap read_png(pn::data_view png) {
+    ArrayPixMap pix(png_size(png));
+    read_png(png, pix);
+    return pix;
+}
+
+Size png_size(pn::data_view png) {
+    // The signature is followed by the IHDR chunk: its length, its type, then the image width
+    // and height, as big-endian 32-bit integers.
+    const uint8_t* p = png.data();
+    if ((png.size() < 24) || (png_sig_cmp(p, 0, 8) != 0)) {
+        throw std::runtime_error("invalid png signature");
+    } else if (memcmp(p + 12, "IHDR", 4) != 0) {
+        throw std::runtime_error("missing png header");
+    }
+    uint32_t width  = (uint32_t(p[16]) << 24) | (p[17] << 16) | (p[18] << 8) | p[19];
+    uint32_t height = (uint32_t(p[20]) << 24) | (p[21] << 16) | (p[22] << 8) | p[23];
+    if ((width > PNG_UINT_31_MAX) || (height > PNG_UINT_31_MAX)) {
+        throw std::runtime_error("invalid png size");
+    }
+    return Size(width, height);
+}
+
+void read_png(pn::data_view data, PixMap& pix) {
+    Size size = png_size(data);
+    if (size != pix.size()) {
+        throw std::runtime_error(
+                pn::format("png is {0}x{1}, not {2}x{3}", size.width, size.height,
+                           pix.size().width, pix.size().height)
+                        .c_str());
+    }
+
+    png_struct* png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    if (!png) {
+        throw std::runtime_error("couldn't create png_struct");
+    }
+
+    png_info* info = png_create_info_struct(png);
+    if (!info) {
+        png_destroy_read_struct(&png, NULL, NULL);
+        throw std::runtime_error("couldn't create png_info");
+    }
+
+    if (setjmp(png_jmpbuf(png))) {
+        png_destroy_read_struct(&png, &info, NULL);
+        throw std::runtime_error("reading png failed");
+    }
+
+    // libpng still copies compressed data into its own buffer, but straight from `data`, with
+    // no stream in between; rows are inflated directly into `pix`.
+    PngMemory in = {data.data() + 8, static_cast<size_t>(data.size() - 8)};
+    png_set_sig_bytes(png, 8);
+    png_set_read_fn(png, &in, png_read_memory);
+    read_png_info(png, info);
+    read_png_rows(png, pix);
+
+    png_destroy_read_struct(&png, &info, NULL);
+}
+
 void PixMap::encode(pn::output_view out) {
     png_struct* png = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
     if (!png) {
@@ -0,0 +1,342 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2008-2017 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include "drawing/pix-kernels.hpp"
+
+#include <stdint.h>
+#include <string.h>
+#include <stdexcept>
+
+// The SIMD kernels are only built for x86-64, where doubles are never computed with x87's extra
+// precision, so that composite_row() can match the scalar version exactly.
+#if defined(__x86_64__) && defined(__GNUC__)
+#define ANTARES_PIX_KERNELS_X86 1
+#include <immintrin.h>
+#define ANTARES_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace antares {
+
+namespace {
+
+struct Kernels {
+    void (*fill_row)(RgbColor* row, RgbColor color, int width);
+    void (*composite_row)(RgbColor* under, const RgbColor* over, int width);
+    void (*tint_row)(RgbColor* image, const RgbColor* overlay, Hue hue, int width);
+};
+
+void fill_row_scalar(RgbColor* row, RgbColor color, int width) {
+    for (int x = 0; x < width; ++x) {
+        row[x] = color;
+    }
+}
+
+RgbColor composite_pixel(const RgbColor& under, const RgbColor& over) {
+    if ((over.alpha == 0) && (under.alpha == 0)) {
+        return RgbColor::clear();  // Avoids dividing by zero below.
+    }
+    const double oa = over.alpha / 255.0;
+    const double ua = under.alpha / 255.0;
+
+    // TODO(sfiera): if we're going to do anything like this in the long run, we should
+    // require that alpha be pre-multiplied with the color components.  We should probably
+    // also use integral arithmetic.
+    double red   = (over.red * oa) + ((under.red * ua) * (1.0 - oa));
+    double green = (over.green * oa) + ((under.green * ua) * (1.0 - oa));
+    double blue  = (over.blue * oa) + ((under.blue * ua) * (1.0 - oa));
+    double alpha = oa + (ua * (1.0 - oa));
+    return rgba(red / alpha, green / alpha, blue / alpha, alpha * 255);
+}
+
+void composite_row_scalar(RgbColor* under, const RgbColor* over, int width) {
+    for (int x = 0; x < width; ++x) {
+        under[x] = composite_pixel(under[x], over[x]);
+    }
+}
+
+void tint_row_scalar(RgbColor* image, const RgbColor* overlay, Hue hue, int width) {
+    for (int x = 0; x < width; ++x) {
+        RgbColor over  = overlay[x];
+        uint8_t  value = over.red;
+        uint8_t  frac  = over.alpha;
+        over           = RgbColor::tint(hue, value);
+        RgbColor under = image[x];
+        RgbColor composite;
+        composite.red   = ((over.red * frac) + (under.red * (255 - frac))) / 255;
+        composite.green = ((over.green * frac) + (under.green * (255 - frac))) / 255;
+        composite.blue  = ((over.blue * frac) + (under.blue * (255 - frac))) / 255;
+        composite.alpha = under.alpha;
+        image[x]        = composite;
+    }
+}
+
+const Kernels kScalarKernels = {fill_row_scalar, composite_row_scalar, tint_row_scalar};
+
+#ifdef ANTARES_PIX_KERNELS_X86
+
+// In the integer kernels, each pixel is unpacked into four 16-bit lanes, in memory order: alpha,
+// red, green, blue. All intermediate values fit in 16 bits unsigned: the tint of a shade is at
+// most 65295 before dividing by 256, and the blend at most 255 * 255 before dividing by 255.
+// x / 255 is computed as (x + 1 + (x >> 8)) >> 8, which is exact for x <= 65535 - 255.
+
+uint32_t bits(RgbColor color) {
+    uint32_t result;
+    memcpy(&result, &color, sizeof(result));
+    return result;
+}
+
+ANTARES_TARGET("sse2")
+void fill_row_sse2(RgbColor* row, RgbColor color, int width) {
+    const __m128i c = _mm_set1_epi32(bits(color));
+    int           x = 0;
+    for (; x + 4 <= width; x += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), c);
+    }
+    fill_row_scalar(row + x, color, width - x);
+}
+
+// Stores four 32-bit lanes, holding red, green, blue, and alpha, as one pixel.
+ANTARES_TARGET("sse2")
+void store_pixel_sse2(RgbColor* pixel, __m128i rgba) {
+    __m128i argb = _mm_shuffle_epi32(rgba, _MM_SHUFFLE(2, 1, 0, 3));
+    argb         = _mm_packs_epi32(argb, argb);
+    argb         = _mm_packus_epi16(argb, argb);
+    int32_t p    = _mm_cvtsi128_si32(argb);
+    memcpy(static_cast<void*>(pixel), &p, sizeof(p));
+}
+
+// Performs the same double operations as composite_pixel(), in the same order, two lanes at a
+// time: red and green, then blue and alpha.
+ANTARES_TARGET("sse2")
+void composite_row_sse2(RgbColor* under, const RgbColor* over, int width) {
+    const __m128d max = _mm_set1_pd(255.0);
+    const __m128d one = _mm_set1_pd(1.0);
+    for (int x = 0; x < width; ++x) {
+        const RgbColor o = over[x];
+        const RgbColor u = under[x];
+        if ((o.alpha == 0) && (u.alpha == 0)) {
+            under[x] = RgbColor::clear();
+            continue;
+        }
+        const __m128d oa    = _mm_div_pd(_mm_set1_pd(o.alpha), max);
+        const __m128d ua    = _mm_div_pd(_mm_set1_pd(u.alpha), max);
+        const __m128d ta    = _mm_sub_pd(one, oa);
+        const __m128d alpha = _mm_add_pd(oa, _mm_mul_pd(ua, ta));
+        __m128d       rg    = _mm_add_pd(
+                _mm_mul_pd(_mm_setr_pd(o.red, o.green), oa),
+                _mm_mul_pd(_mm_mul_pd(_mm_setr_pd(u.red, u.green), ua), ta));
+        __m128d b = _mm_add_pd(
+                _mm_mul_pd(_mm_set1_pd(o.blue), oa),
+                _mm_mul_pd(_mm_mul_pd(_mm_set1_pd(u.blue), ua), ta));
+        rg         = _mm_div_pd(rg, alpha);
+        __m128d ba = _mm_move_sd(_mm_mul_pd(alpha, max), _mm_div_pd(b, alpha));
+        store_pixel_sse2(
+                &under[x], _mm_unpacklo_epi64(_mm_cvttpd_epi32(rg), _mm_cvttpd_epi32(ba)));
+    }
+}
+
+struct TintConstants {
+    uint16_t diffuse[8];
+    uint16_t ambient[8];
+    uint16_t keep[8];  // 0xffff in the alpha lanes, where the image is kept.
+};
+
+TintConstants tint_constants(Hue hue) {
+    RgbColor::TintCoefficients t = RgbColor::tint_coefficients(hue);
+    TintConstants              c;
+    for (int i = 0; i < 8; i += 4) {
+        c.diffuse[i] = c.ambient[i] = 0;
+        c.keep[i]                   = 0xffff;
+        for (int j = 0; j < 3; ++j) {
+            c.diffuse[i + j + 1] = t.diffuse[j];
+            c.ambient[i + j + 1] = t.ambient[j];
+            c.keep[i + j + 1]    = 0;
+        }
+    }
+    return c;
+}
+
+// Tints two pixels of `under`, given as 16-bit lanes, with two pixels of `over`.
+ANTARES_TARGET("sse2")
+__m128i tint_pixels_sse2(
+        __m128i under, __m128i over, __m128i diffuse, __m128i ambient, __m128i keep) {
+    const __m128i max   = _mm_set1_epi16(255);
+    const __m128i one   = _mm_set1_epi16(1);
+    const __m128i value = _mm_shufflehi_epi16(
+            _mm_shufflelo_epi16(over, _MM_SHUFFLE(1, 1, 1, 1)), _MM_SHUFFLE(1, 1, 1, 1));
+    const __m128i frac = _mm_shufflehi_epi16(
+            _mm_shufflelo_epi16(over, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(0, 0, 0, 0));
+    const __m128i tint =
+            _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(diffuse, value), ambient), 8);
+    const __m128i sum = _mm_add_epi16(
+            _mm_mullo_epi16(tint, frac), _mm_mullo_epi16(under, _mm_sub_epi16(max, frac)));
+    const __m128i blend =
+            _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(sum, one), _mm_srli_epi16(sum, 8)), 8);
+    return _mm_or_si128(_mm_and_si128(keep, under), _mm_andnot_si128(keep, blend));
+}
+
+ANTARES_TARGET("sse2")
+void tint_row_sse2(RgbColor* image, const RgbColor* overlay, Hue hue, int width) {
+    const TintConstants c = tint_constants(hue);
+    const __m128i diffuse = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c.diffuse));
+    const __m128i ambient = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c.ambient));
+    const __m128i keep    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c.keep));
+    const __m128i zero    = _mm_setzero_si128();
+    int           x       = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i* p     = reinterpret_cast<__m128i*>(image + x);
+        __m128i  under = _mm_loadu_si128(p);
+        __m128i  over  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(overlay + x));
+        __m128i  lo    = tint_pixels_sse2(
+                _mm_unpacklo_epi8(under, zero), _mm_unpacklo_epi8(over, zero), diffuse, ambient,
+                keep);
+        __m128i hi = tint_pixels_sse2(
+                _mm_unpackhi_epi8(under, zero), _mm_unpackhi_epi8(over, zero), diffuse, ambient,
+                keep);
+        _mm_storeu_si128(p, _mm_packus_epi16(lo, hi));
+    }
+    tint_row_scalar(image + x, overlay + x, hue, width - x);
+}
+
+const Kernels kSse2Kernels = {fill_row_sse2, composite_row_sse2, tint_row_sse2};
+
+ANTARES_TARGET("avx2")
+void fill_row_avx2(RgbColor* row, RgbColor color, int width) {
+    const __m256i c = _mm256_set1_epi32(bits(color));
+    int           x = 0;
+    for (; x + 8 <= width; x += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(row + x), c);
+    }
+    fill_row_scalar(row + x, color, width - x);
+}
+
+ANTARES_TARGET("avx2")
+__m256i tint_pixels_avx2(
+        __m256i under, __m256i over, __m256i diffuse, __m256i ambient, __m256i keep) {
+    const __m256i max   = _mm256_set1_epi16(255);
+    const __m256i one   = _mm256_set1_epi16(1);
+    const __m256i value = _mm256_shufflehi_epi16(
+            _mm256_shufflelo_epi16(over, _MM_SHUFFLE(1, 1, 1, 1)), _MM_SHUFFLE(1, 1, 1, 1));
+    const __m256i frac = _mm256_shufflehi_epi16(
+            _mm256_shufflelo_epi16(over, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(0, 0, 0, 0));
+    const __m256i tint =
+            _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(diffuse, value), ambient), 8);
+    const __m256i sum = _mm256_add_epi16(
+            _mm256_mullo_epi16(tint, frac),
+            _mm256_mullo_epi16(under, _mm256_sub_epi16(max, frac)));
+    const __m256i blend = _mm256_srli_epi16(
+            _mm256_add_epi16(_mm256_add_epi16(sum, one), _mm256_srli_epi16(sum, 8)), 8);
+    return _mm256_or_si256(_mm256_and_si256(keep, under), _mm256_andnot_si256(keep, blend));
+}
+
+ANTARES_TARGET("avx2")
+__m256i broadcast_avx2(const uint16_t* lanes) {
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes)));
+}
+
+// Unpacking and packing both work within 128-bit halves, so they undo each other, and pixels
+// keep their places.
+ANTARES_TARGET("avx2")
+void tint_row_avx2(RgbColor* image, const RgbColor* overlay, Hue hue, int width) {
+    const TintConstants c       = tint_constants(hue);
+    const __m256i       diffuse = broadcast_avx2(c.diffuse);
+    const __m256i       ambient = broadcast_avx2(c.ambient);
+    const __m256i       keep    = broadcast_avx2(c.keep);
+    const __m256i       zero    = _mm256_setzero_si256();
+    int                 x       = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i* p     = reinterpret_cast<__m256i*>(image + x);
+        __m256i  under = _mm256_loadu_si256(p);
+        __m256i  over  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(overlay + x));
+        __m256i  lo    = tint_pixels_avx2(
+                _mm256_unpacklo_epi8(under, zero), _mm256_unpacklo_epi8(over, zero), diffuse,
+                ambient, keep);
+        __m256i hi = tint_pixels_avx2(
+                _mm256_unpackhi_epi8(under, zero), _mm256_unpackhi_epi8(over, zero), diffuse,
+                ambient, keep);
+        _mm256_storeu_si256(p, _mm256_packus_epi16(lo, hi));
+    }
+    tint_row_sse2(image + x, overlay + x, hue, width - x);
+}
+
+// composite_row() is limited by division, which is no faster with wider vectors.
+const Kernels kAvx2Kernels = {fill_row_avx2, composite_row_sse2, tint_row_avx2};
+
+#endif  // ANTARES_PIX_KERNELS_X86
+
+const Kernels& kernels_for(PixKernels kernels) {
+    switch (kernels) {
+        case PixKernels::SCALAR: return kScalarKernels;
+#ifdef ANTARES_PIX_KERNELS_X86
+        case PixKernels::SSE2: return kSse2Kernels;
+        case PixKernels::AVX2: return kAvx2Kernels;
+#endif
+        default: throw std::runtime_error("unsupported pixel kernels");
+    }
+}
+
+PixKernels best_kernels() {
+    for (PixKernels k : {PixKernels::AVX2, PixKernels::SSE2}) {
+        if (pix_kernels_supported(k)) {
+            return k;
+        }
+    }
+    return PixKernels::SCALAR;
+}
+
+// Chosen on first use, which may be on a worker thread; initializing a local static is safe.
+PixKernels& selected() {
+    static PixKernels kernels = best_kernels();
+    return kernels;
+}
+
+}  // namespace
+
+bool pix_kernels_supported(PixKernels kernels) {
+    switch (kernels) {
+        case PixKernels::SCALAR: return true;
+#ifdef ANTARES_PIX_KERNELS_X86
+        case PixKernels::SSE2: __builtin_cpu_init(); return __builtin_cpu_supports("sse2");
+        case PixKernels::AVX2: __builtin_cpu_init(); return __builtin_cpu_supports("avx2");
+#endif
+        default: return false;
+    }
+}
+
+PixKernels pix_kernels() { return selected(); }
+
+void set_pix_kernels(PixKernels kernels) {
+    if (!pix_kernels_supported(kernels)) {
+        throw std::runtime_error("unsupported pixel kernels");
+    }
+    selected() = kernels;
+}
+
+void fill_row(RgbColor* row, RgbColor color, int width) {
+    kernels_for(selected()).fill_row(row, color, width);
+}
+
+void composite_row(RgbColor* under, const RgbColor* over, int width) {
+    kernels_for(selected()).composite_row(under, over, width);
+}
+
+void tint_row(RgbColor* image, const RgbColor* overlay, Hue hue, int width) {
+    kernels_for(selected()).tint_row(image, overlay, hue, width);
+}
+
+}  // namespace antares
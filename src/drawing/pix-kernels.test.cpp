@@ -0,0 +1,122 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2008-2017 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include "drawing/pix-kernels.hpp"
+
+#include <gmock/gmock.h>
+#include <random>
+#include <vector>
+
+using testing::ContainerEq;
+
+namespace antares {
+namespace {
+
+const int kRows     = 2000;
+const int kMaxWidth = 40;  // Leaves a scalar tail of every length after the vector loops.
+
+class PixKernelsTest : public testing::Test {
+  public:
+    PixKernelsTest() : _initial(pix_kernels()) {}
+    ~PixKernelsTest() { set_pix_kernels(_initial); }
+
+  protected:
+    // Every supported set of kernels, other than the scalar one.
+    std::vector<PixKernels> simd() const {
+        std::vector<PixKernels> result;
+        for (PixKernels k : {PixKernels::SSE2, PixKernels::AVX2}) {
+            if (pix_kernels_supported(k)) {
+                result.push_back(k);
+            }
+        }
+        return result;
+    }
+
+    // Random pixels, with fully clear and fully opaque alphas overrepresented.
+    std::vector<RgbColor> row(int width) {
+        std::vector<RgbColor> result;
+        for (int i = 0; i < width; ++i) {
+            uint8_t alpha = _random();
+            switch (_random() % 4) {
+                case 0: alpha = 0x00; break;
+                case 1: alpha = 0xff; break;
+            }
+            result.push_back(rgba(_random(), _random(), _random(), alpha));
+        }
+        return result;
+    }
+
+    int width() { return _random() % (kMaxWidth + 1); }
+
+  private:
+    const PixKernels _initial;
+    std::mt19937     _random{0};
+};
+
+TEST_F(PixKernelsTest, Fill) {
+    for (PixKernels k : simd()) {
+        for (int i = 0; i < kRows; ++i) {
+            std::vector<RgbColor> expected = row(width());
+            std::vector<RgbColor> actual   = expected;
+            RgbColor              color    = row(1)[0];
+
+            set_pix_kernels(PixKernels::SCALAR);
+            fill_row(expected.data(), color, expected.size());
+            set_pix_kernels(k);
+            fill_row(actual.data(), color, actual.size());
+            EXPECT_THAT(actual, ContainerEq(expected));
+        }
+    }
+}
+
+TEST_F(PixKernelsTest, Composite) {
+    for (PixKernels k : simd()) {
+        for (int i = 0; i < kRows; ++i) {
+            std::vector<RgbColor> expected = row(width());
+            std::vector<RgbColor> actual   = expected;
+            std::vector<RgbColor> over     = row(expected.size());
+
+            set_pix_kernels(PixKernels::SCALAR);
+            composite_row(expected.data(), over.data(), expected.size());
+            set_pix_kernels(k);
+            composite_row(actual.data(), over.data(), actual.size());
+            EXPECT_THAT(actual, ContainerEq(expected));
+        }
+    }
+}
+
+TEST_F(PixKernelsTest, Tint) {
+    for (PixKernels k : simd()) {
+        for (int h = 0; h < 16; ++h) {
+            for (int i = 0; i < kRows; ++i) {
+                std::vector<RgbColor> expected = row(width());
+                std::vector<RgbColor> actual   = expected;
+                std::vector<RgbColor> overlay  = row(expected.size());
+
+                set_pix_kernels(PixKernels::SCALAR);
+                tint_row(expected.data(), overlay.data(), static_cast<Hue>(h), expected.size());
+                set_pix_kernels(k);
+                tint_row(actual.data(), overlay.data(), static_cast<Hue>(h), actual.size());
+                EXPECT_THAT(actual, ContainerEq(expected));
+            }
+        }
+    }
+}
+
+}  // namespace
+}  // namespace antares
@@ -26,34 +26,63 @@
 #include "data/resource.hpp"
 #include "data/sprite-data.hpp"
 #include "drawing/color.hpp"
+#include "drawing/pix-kernels.hpp"
 #include "game/sys.hpp"
+#include "lang/defines.hpp"
 #include "video/driver.hpp"
 
-using sfz::range;
 using std::unique_ptr;
 using std::vector;
 
 namespace antares {
 
-NatePixTable::NatePixTable(pn::string_view name, Hue hue) {
-    SpriteData  data    = Resource::sprite_data(name);
-    ArrayPixMap image   = Resource::sprite_image(name);
-    ArrayPixMap overlay = Resource::sprite_overlay(name);
+static ANTARES_GLOBAL NatePixTable::Tinting pix_tinting = NatePixTable::Tinting::PRECOMPOSITED;
 
-    if (image.size() != overlay.size()) {
+void NatePixTable::set_tinting(Tinting tinting) { pix_tinting = tinting; }
+
+NatePixTable::Tinting NatePixTable::tinting() { return pix_tinting; }
+
+NatePixTable::NatePixTable(pn::string_view name, Hue hue) : NatePixTable(decode(name, hue)) {
+    upload();
+}
+
+NatePixTable NatePixTable::decode(pn::string_view name, Hue hue) {
+    NatePixTable t;
+    t._name = name.copy();
+
+    SpriteData              data    = Resource::sprite_data(name);
+    std::unique_ptr<PixMap> image   = Resource::sprite_image(name);
+    std::unique_ptr<PixMap> overlay = Resource::sprite_overlay(name);
+
+    if (image->size() != overlay->size()) {
         throw std::runtime_error("size mismatch between image and overlay");
     }
     for (SpriteData::Frame frame : data.frames) {
-        const int i = _frames.size();
-        Rect      sprite{frame.left, frame.top, frame.right, frame.bottom};
-        Rect      bounds = sprite;
+        Rect sprite{frame.left, frame.top, frame.right, frame.bottom};
+        Rect bounds = sprite;
         bounds.offset(-frame.cx, -frame.cy);
-        if (hue == Hue::GRAY) {
-            _frames.emplace_back(bounds, image.view(sprite), name, i);
+        if ((hue == Hue::GRAY) && (tinting() == Tinting::PRECOMPOSITED)) {
+            t._frames.emplace_back(bounds, image->view(sprite));
         } else {
-            _frames.emplace_back(bounds, image.view(sprite), name, i, overlay.view(sprite), hue);
+            t._frames.emplace_back(bounds, image->view(sprite), overlay->view(sprite), hue);
         }
     }
+    return t;
+}
+
+void NatePixTable::upload() {
+    for (int i = 0; i < _frames.size(); ++i) {
+        _frames[i].build(_name, i);
+    }
+}
+
+NatePixTable NatePixTable::hued(Hue hue) const {
+    NatePixTable t;
+    t._name = _name.copy();
+    for (const Frame& frame : _frames) {
+        t._frames.emplace_back(frame, hue);
+    }
+    return t;
 }
 
 NatePixTable::~NatePixTable() {}
@@ -62,51 +91,55 @@ const NatePixTable::Frame& NatePixTable::at(size_t index) const { return _frames
 
 size_t NatePixTable::size() const { return _size; }
 
-NatePixTable::Frame::Frame(
-        Rect bounds, const PixMap& image, pn::string_view name, int frame, const PixMap& overlay,
-        Hue hue)
-        : _bounds(bounds), _pix_map(bounds.width(), bounds.height()) {
+NatePixTable::Frame::Frame(Rect bounds, const PixMap& image, const PixMap& overlay, Hue hue)
+        : _bounds(bounds), _pix_map(std::make_shared<ArrayPixMap>(bounds.size())) {
     load_image(image);
-    load_overlay(overlay, hue);
-    build(name, frame);
+    if (tinting() == Tinting::SHADER) {
+        _overlay = std::make_shared<ArrayPixMap>(bounds.size());
+        _overlay->copy(overlay);
+        _hue = hue;
+    } else {
+        load_overlay(overlay, hue);
+    }
 }
 
-NatePixTable::Frame::Frame(Rect bounds, const PixMap& image, pn::string_view name, int frame)
-        : _bounds(bounds), _pix_map(bounds.width(), bounds.height()) {
+NatePixTable::Frame::Frame(Rect bounds, const PixMap& image)
+        : _bounds(bounds), _pix_map(std::make_shared<ArrayPixMap>(bounds.size())) {
     load_image(image);
-    build(name, frame);
 }
 
+NatePixTable::Frame::Frame(const Frame& base, Hue hue)
+        : _bounds(base._bounds),
+          _pix_map(base._pix_map),
+          _overlay(base._overlay),
+          _hue(hue),
+          _texture(base._texture.hued(hue)) {}
+
 NatePixTable::Frame::~Frame() {}
 
-void NatePixTable::Frame::load_image(const PixMap& pix) { _pix_map.copy(pix); }
+void NatePixTable::Frame::load_image(const PixMap& pix) { _pix_map->copy(pix); }
 
 void NatePixTable::Frame::load_overlay(const PixMap& pix, Hue hue) {
-    for (auto x : range(width())) {
-        for (auto y : range(height())) {
-            RgbColor over  = pix.get(x, y);
-            uint8_t  value = over.red;
-            uint8_t  frac  = over.alpha;
-            over           = RgbColor::tint(hue, value);
-            RgbColor under = _pix_map.get(x, y);
-            RgbColor composite;
-            composite.red   = ((over.red * frac) + (under.red * (255 - frac))) / 255;
-            composite.green = ((over.green * frac) + (under.green * (255 - frac))) / 255;
-            composite.blue  = ((over.blue * frac) + (under.blue * (255 - frac))) / 255;
-            composite.alpha = under.alpha;
-            _pix_map.set(x, y, composite);
-        }
+    for (int y = 0; y < height(); ++y) {
+        tint_row(_pix_map->mutable_row(y), pix.row(y), hue, width());
     }
 }
 
 uint16_t       NatePixTable::Frame::width() const { return _bounds.width(); }
 uint16_t       NatePixTable::Frame::height() const { return _bounds.height(); }
 Point          NatePixTable::Frame::center() const { return {-_bounds.left, -_bounds.top}; }
-const PixMap&  NatePixTable::Frame::pix_map() const { return _pix_map; }
+const PixMap&  NatePixTable::Frame::pix_map() const { return *_pix_map; }
 const Texture& NatePixTable::Frame::texture() const { return _texture; }
 
 void NatePixTable::Frame::build(pn::string_view name, int frame) {
-    _texture = sys.video->texture(pn::format("/sprites/{0}%{1}", name, frame), _pix_map, 1);
+    pn::string texture_name = pn::format("/sprites/{0}%{1}", name, frame);
+    if (!_overlay) {
+        _texture = sys.video->texture(texture_name, *_pix_map, 1);
+    } else if (_hue == Hue::GRAY) {
+        _texture = sys.video->texture(texture_name, *_pix_map, *_overlay, 1);
+    } else {
+        _texture = sys.video->texture(texture_name, *_pix_map, *_overlay, 1).hued(_hue);
+    }
 }
 
 }  // namespace antares
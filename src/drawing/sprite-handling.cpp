@@ -18,6 +18,8 @@
 
 #include "drawing/sprite-handling.hpp"
 
+#include <chrono>
+#include <memory>
 #include <numeric>
 #include <sfz/sfz.hpp>
 
@@ -102,6 +104,12 @@ void ResetAllSprites() {
 }
 
 void Pix::reset() {
+    for (auto& kv : _decoding) {
+        kv.second.wait();
+    }
+    _order.clear();
+    _decoding.clear();
+    _requested = 0;
     _pix.clear();
     _cursor.reset(new NatePixTable("gui/cursor", Hue::GRAY));
 }
@@ -110,16 +118,69 @@ NatePixTable* Pix::add(pn::string_view name, Hue hue) {
     NatePixTable* result = get(name, hue);
     if (result) {
         return result;
+    } else if ((NatePixTable::tinting() == NatePixTable::Tinting::SHADER) && (hue != Hue::GRAY)) {
+        add(name, Hue::GRAY);
+        return get(name, hue);
     }
 
     auto it = _pix.emplace(std::make_pair(name.copy(), hue), NatePixTable(name, hue)).first;
     return &it->second;
 }
 
+namespace {
+
+struct DecodeTable {
+    pn::string name;
+    Hue        hue;
+    NatePixTable operator()() const { return NatePixTable::decode(name, hue); }
+};
+
+}  // namespace
+
+void Pix::request(pn::string_view id, Hue hue) {
+    if (NatePixTable::tinting() == NatePixTable::Tinting::SHADER) {
+        hue = Hue::GRAY;  // get() makes the other hues from it.
+    }
+    Key key{id.copy(), hue};
+    if ((_pix.find(key) != _pix.end()) || (_decoding.find(key) != _decoding.end())) {
+        return;
+    } else if (!Resource::thread_safe()) {
+        add(id, hue);
+        return;
+    }
+
+    auto task = std::make_shared<std::packaged_task<NatePixTable()>>(DecodeTable{id.copy(), hue});
+    _order.push_back(_decoding.emplace(std::move(key), task->get_future()).first);
+    _work.post([task] { (*task)(); });
+    ++_requested;
+}
+
+int Pix::upload() {
+    if (!_order.empty()) {
+        _order.front()->second.wait();
+    }
+    while (!_order.empty() && (_order.front()->second.wait_for(std::chrono::seconds(0)) ==
+                               std::future_status::ready)) {
+        auto it = _order.front();
+        _order.pop_front();
+        NatePixTable table = it->second.get();
+        table.upload();
+        _pix.emplace(Key{it->first.first.copy(), it->first.second}, std::move(table));
+        _decoding.erase(it);
+    }
+    return _order.size();
+}
+
 NatePixTable* Pix::get(pn::string_view id, Hue hue) {
     auto it = _pix.find({id.copy(), hue});
     if (it != _pix.end()) {
         return &it->second;
+    } else if ((NatePixTable::tinting() == NatePixTable::Tinting::SHADER) && (hue != Hue::GRAY)) {
+        // Every hue shares the textures of the gray table.
+        it = _pix.find({id.copy(), Hue::GRAY});
+        if (it != _pix.end()) {
+            return &_pix.emplace(Key{id.copy(), hue}, it->second.hued(hue)).first->second;
+        }
     }
     return nullptr;
 }
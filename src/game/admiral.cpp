@@ -25,7 +25,9 @@
 #include "game/globals.hpp"
 #include "game/space-object.hpp"
 #include "game/sys.hpp"
+#include "game/target-scoring.hpp"
 #include "lang/casts.hpp"
+#include "lang/defines.hpp"
 #include "math/macros.hpp"
 #include "math/random.hpp"
 #include "math/units.hpp"
@@ -39,13 +41,9 @@ namespace antares {
 static const int32_t kDestinationNameLen = 17;
 static const int32_t kAdmiralNameLen     = 31;
 
-static const Fixed kUnimportantTarget       = Fixed::from_float(0.000);
-static const Fixed kMostImportantTarget     = Fixed::from_float(2.000);
-static const Fixed kLeastImportantTarget    = Fixed::from_float(1.000);
-static const Fixed kVeryImportantTarget     = Fixed::from_float(1.375);
-static const Fixed kImportantTarget         = Fixed::from_float(1.250);
-static const Fixed kSomewhatImportantTarget = Fixed::from_float(1.125);
-static const Fixed kAbsolutelyEssential     = Fixed::from_float(128.0);
+static const int32_t kScoringBatchSize = 4;  // ships per think() in Scoring::BATCHED.
+
+static ANTARES_GLOBAL Admiral::Scoring admiral_scoring = Admiral::Scoring::INCREMENTAL;
 
 static bool could_target_per_destination_flag(const BaseObject& base, const SpaceObject& target) {
     return base.ai.target.force.base.has_value()
@@ -267,6 +265,43 @@ void RecalcAllAdmiralBuildData() {
     }
 }
 
+void Admiral::add_object(Handle<SpaceObject> o) {
+    o->previousOwnedObject = SpaceObject::none();
+    o->nextOwnedObject     = _objects;
+    if (_objects.get()) {
+        _objects->previousOwnedObject = o;
+    }
+    _objects = o;
+    ++_object_count;
+    ++_base_counts[o->base];
+}
+
+void Admiral::remove_object(Handle<SpaceObject> o) {
+    if (o->previousOwnedObject.get()) {
+        o->previousOwnedObject->nextOwnedObject = o->nextOwnedObject;
+    }
+    if (o->nextOwnedObject.get()) {
+        o->nextOwnedObject->previousOwnedObject = o->previousOwnedObject;
+    }
+    if (_objects == o) {
+        _objects = o->nextOwnedObject;
+    }
+    o->previousOwnedObject = o->nextOwnedObject = SpaceObject::none();
+    --_object_count;
+    auto it = _base_counts.find(o->base);
+    if ((it != _base_counts.end()) && (--it->second == 0)) {
+        _base_counts.erase(it);
+    }
+}
+
+int32_t Admiral::object_count(const BaseObject* base) const {
+    if (!base) {
+        return _object_count;
+    }
+    auto it = _base_counts.find(base);
+    return (it == _base_counts.end()) ? 0 : it->second;
+}
+
 Hue GetAdmiralColor(Handle<Admiral> a) {
     if (!a.get()) {
         return Hue::GRAY;
@@ -582,6 +617,92 @@ static void AdmiralBuildAtObject(
     }
 }
 
+// The object whose local strengths are used when considering `dest`: the last object in
+// `dest`’s far-object list (excluding its tail) that shares `dest`’s distance grid.
+static const SpaceObject& grid_representative(const SpaceObject& dest) {
+    const SpaceObject* result = &dest;
+    for (const SpaceObject* step = &dest; step->nextFarObject.get();
+         step                    = step->nextFarObject.get()) {
+        if ((step->distanceGrid.h == dest.distanceGrid.h) &&
+            (step->distanceGrid.v == dest.distanceGrid.v)) {
+            result = step;
+        }
+    }
+    return *result;
+}
+
+static ScoringShip scoring_ship(const SpaceObject& ship, bool blitzkrieg) {
+    ScoringShip result;
+    result.owner        = ship.owner.get() ? ship.owner.number() : -1;
+    result.order_flags  = ship.base->orderFlags;
+    result.escort_class = ship.base->ai.escort.class_;
+    result.guarding     = (ship.duty == eGuardDuty);
+    result.free         = (ship.duty == eGuardDuty) || (ship.duty == eNoDuty);
+    result.blitzkrieg   = blitzkrieg;
+    result.h            = ship.location.h;
+    result.v            = ship.location.v;
+    return result;
+}
+
+static ScoringTarget scoring_target(const SpaceObject& dest) {
+    const SpaceObject& local = grid_representative(dest);
+    ScoringTarget      result;
+    result.owner                 = dest.owner.get() ? dest.owner.number() : -1;
+    result.is_destination        = dest.attributes & kIsDestination;
+    result.escort_class          = dest.base->ai.escort.class_;
+    result.escort_strength       = dest.escortStrength;
+    result.escort_need           = dest.base->ai.escort.need;
+    result.h                     = dest.location.h;
+    result.v                     = dest.location.v;
+    result.local_owner           = local.owner.get() ? local.owner.number() : -1;
+    result.local_friend_strength = local.localFriendStrength;
+    result.local_foe_strength    = local.localFoeStrength;
+    return result;
+}
+
+// Whether `dest` has the tags that `ship` prefers, and the tags it requires. Tags are only
+// compared if `ship`’s order flags ask for them.
+static bool prefers_tags(const SpaceObject& ship, const SpaceObject& dest) {
+    return (ship.base->orderFlags & kSoftTargetMatchesTags) &&
+           tags_match(*dest.base, ship.base->ai.target.prefer.tags);
+}
+
+static bool forced_tags(const SpaceObject& ship, const SpaceObject& dest) {
+    return (ship.base->orderFlags & kHardTargetMatchesTags) &&
+           tags_match(*dest.base, ship.base->ai.target.force.tags);
+}
+
+namespace {
+
+// Possible destinations for Scoring::BATCHED, gathered once per tick, before any admiral
+// thinks, so that every admiral scores its ships against the same snapshot.
+struct ScoringCandidates {
+    std::vector<Handle<SpaceObject>> object;
+    ScoringTargets                   targets;
+    std::vector<int32_t>             prefers;  // per ship, scratch space for score().
+    std::vector<int32_t>             forced;
+    std::vector<Fixed>               values;
+};
+
+}  // namespace
+
+static ANTARES_GLOBAL ScoringCandidates scoring_candidates;
+
+static void gather_scoring_candidates() {
+    scoring_candidates.object.clear();
+    scoring_candidates.targets.clear();
+    for (auto o = g.root; o.get(); o = o->nextObject) {
+        if ((o->attributes & kCanBeDestination) && (o->active == kObjectInUse)) {
+            scoring_candidates.object.push_back(o);
+            scoring_candidates.targets.push_back(scoring_target(*o));
+        }
+    }
+    size_t n = scoring_candidates.object.size();
+    scoring_candidates.prefers.resize(n);
+    scoring_candidates.forced.resize(n);
+    scoring_candidates.values.resize(n);
+}
+
 void AdmiralThink() {
     for (auto destBalance : Destination::all()) {
         destBalance->buildTime -= kMajorTick;
@@ -601,21 +722,17 @@ void AdmiralThink() {
         }
     }
 
+    if (admiral_scoring == Admiral::Scoring::BATCHED) {
+        gather_scoring_candidates();
+    }
     for (auto a : Admiral::all()) {
         a->think();
     }
 }
 
-void Admiral::think() {
-    Handle<SpaceObject> anObject;
-    Handle<SpaceObject> destObject;
-    Handle<SpaceObject> otherDestObject;
-    Handle<SpaceObject> stepObject;
-    Handle<SpaceObject> origObject;
-    int32_t             difference;
-    Fixed               friendValue, foeValue, thisValue;
-    Point               gridLoc;
+void Admiral::set_scoring(Scoring scoring) { admiral_scoring = scoring; }
 
+void Admiral::think() {
     if (!(_attributes & kAIsComputer) || (_attributes & kAIsRemote)) {
         return;
     }
@@ -625,10 +742,8 @@ void Admiral::think() {
         if (_blitzkrieg <= 0) {
             // Really 48:
             _blitzkrieg = 0 - (g.random.next(1200) + 1200);
-            for (auto anObject : SpaceObject::all()) {
-                if (anObject->owner.get() == this) {
-                    anObject->currentTargetValue = Fixed::zero();
-                }
+            for (auto o = _objects; o.get(); o = o->nextOwnedObject) {
+                o->currentTargetValue = Fixed::zero();
             }
         }
     } else {
@@ -636,14 +751,55 @@ void Admiral::think() {
         if (_blitzkrieg >= 0) {
             // Really 48:
             _blitzkrieg = g.random.next(1200) + 1200;
-            for (auto anObject : SpaceObject::all()) {
-                if (anObject->owner.get() == this) {
-                    anObject->currentTargetValue = Fixed::zero();
-                }
+            for (auto o = _objects; o.get(); o = o->nextOwnedObject) {
+                o->currentTargetValue = Fixed::zero();
+            }
+        }
+    }
+
+    switch (admiral_scoring) {
+        case Scoring::INCREMENTAL: think_incremental(); break;
+        case Scoring::BATCHED: think_batched(); break;
+    }
+    think_build();
+}
+
+// Commits `anObject` to its best considered target, if that beats its current one.
+void Admiral::decide(Handle<SpaceObject> anObject) {
+    if ((anObject->duty != eEscortDuty) && (anObject->duty != eHostileBaseDuty) &&
+        (anObject->bestConsideredTargetValue > anObject->currentTargetValue)) {
+        _destinationObject = anObject->bestConsideredTargetNumber;
+        _has_destination   = true;
+        if (_destinationObject.get()) {
+            auto destObject = _destinationObject;
+            if (destObject->active == kObjectInUse) {
+                _destinationObjectID         = destObject->id;
+                anObject->currentTargetValue = anObject->bestConsideredTargetValue;
+                Fixed thisValue = anObject->randomSeed.next(Fixed::from_float(0.5)) -
+                                  Fixed::from_float(0.25);
+                thisValue       = (thisValue * anObject->currentTargetValue);
+                anObject->currentTargetValue += thisValue;
+                SetObjectDestination(anObject);
             }
         }
+        _has_destination = false;
+    }
+
+    if ((anObject->duty != eEscortDuty) && (anObject->duty != eHostileBaseDuty)) {
+        _thisFreeEscortStrength += anObject->base->ai.escort.power;
     }
 
+    anObject->bestConsideredTargetValue = kFixedNone;
+}
+
+// Considers one (ship, destination) pair per call, stepping through g.root. This is the
+// original behavior, and must be used to reproduce replays.
+void Admiral::think_incremental() {
+    Handle<SpaceObject> anObject;
+    Handle<SpaceObject> destObject;
+    Handle<SpaceObject> origObject;
+    Fixed               thisValue;
+
     // get the current object
     if (!_considerShip.get()) {
         _considerShip = anObject = g.root;
@@ -675,30 +831,8 @@ void Admiral::think() {
                 // ********************************
                 // SHIP MUST DECIDE, THEN INCREASE CONSIDER SHIP
                 // ********************************
-                if ((anObject->duty != eEscortDuty) && (anObject->duty != eHostileBaseDuty) &&
-                    (anObject->bestConsideredTargetValue > anObject->currentTargetValue)) {
-                    _destinationObject = anObject->bestConsideredTargetNumber;
-                    _has_destination   = true;
-                    if (_destinationObject.get()) {
-                        destObject = _destinationObject;
-                        if (destObject->active == kObjectInUse) {
-                            _destinationObjectID         = destObject->id;
-                            anObject->currentTargetValue = anObject->bestConsideredTargetValue;
-                            thisValue = anObject->randomSeed.next(Fixed::from_float(0.5)) -
-                                        Fixed::from_float(0.25);
-                            thisValue = (thisValue * anObject->currentTargetValue);
-                            anObject->currentTargetValue += thisValue;
-                            SetObjectDestination(anObject);
-                        }
-                    }
-                    _has_destination = false;
-                }
-
-                if ((anObject->duty != eEscortDuty) && (anObject->duty != eHostileBaseDuty)) {
-                    _thisFreeEscortStrength += anObject->base->ai.escort.power;
-                }
+                decide(anObject);
 
-                anObject->bestConsideredTargetValue = kFixedNone;
                 // start back with 1st ship
                 _destinationObject = g.root;
                 destObject         = g.root;
@@ -741,197 +875,75 @@ void Admiral::think() {
             (destObject->active == kObjectInUse) &&
             ((anObject->owner != destObject->owner) ||
              (anObject->base->ai.escort.class_ < destObject->base->ai.escort.class_))) {
-            gridLoc    = destObject->distanceGrid;
-            stepObject = otherDestObject = destObject;
-            while (stepObject->nextFarObject.get()) {
-                if ((stepObject->distanceGrid.h == gridLoc.h) &&
-                    (stepObject->distanceGrid.v == gridLoc.v)) {
-                    otherDestObject = stepObject;
-                }
-                stepObject = stepObject->nextFarObject;
+            thisValue = target_value(
+                    scoring_ship(*anObject, _blitzkrieg > 0), scoring_target(*destObject),
+                    prefers_tags(*anObject, *destObject), forced_tags(*anObject, *destObject));
+
+            if (thisValue > Fixed::zero()) {
+                thisValue += anObject->randomSeed.next(thisValue >> 1) - (thisValue >> 2);
             }
-            if (otherDestObject->owner == anObject->owner) {
-                friendValue = otherDestObject->localFriendStrength;
-                foeValue    = otherDestObject->localFoeStrength;
-            } else {
-                foeValue    = otherDestObject->localFriendStrength;
-                friendValue = otherDestObject->localFoeStrength;
+            if (thisValue > anObject->bestConsideredTargetValue) {
+                anObject->bestConsideredTargetValue  = thisValue;
+                anObject->bestConsideredTargetNumber = _destinationObject;
             }
+        }
+    }
+}
 
-            thisValue = kUnimportantTarget;
-            if (destObject->owner == anObject->owner) {
-                if (destObject->attributes & kIsDestination) {
-                    if (destObject->escortStrength < destObject->base->ai.escort.need) {
-                        thisValue = kAbsolutelyEssential;
-                    } else if (foeValue != Fixed::zero()) {
-                        if (foeValue >= friendValue) {
-                            thisValue = kMostImportantTarget;
-                        } else if (foeValue > (friendValue >> 1)) {
-                            thisValue = kVeryImportantTarget;
-                        } else {
-                            thisValue = kUnimportantTarget;
-                        }
-                    } else {
-                        if ((_blitzkrieg > 0) && (anObject->duty == eGuardDuty)) {
-                            thisValue = kUnimportantTarget;
-                        } else {
-                            if (foeValue > Fixed::zero()) {
-                                thisValue = kSomewhatImportantTarget;
-                            } else {
-                                thisValue = kUnimportantTarget;
-                            }
-                        }
-                    }
-                    if (anObject->base->orderFlags & kSoftTargetIsBase) {
-                        thisValue <<= 3;
-                    }
-                    if (anObject->base->orderFlags & kHardTargetIsNotBase) {
-                        thisValue = Fixed::zero();
-                    }
-                } else {
-                    if (destObject->base->ai.escort.class_ > anObject->base->ai.escort.class_) {
-                        if (foeValue > friendValue) {
-                            thisValue = kMostImportantTarget;
-                        } else {
-                            if (destObject->escortStrength < destObject->base->ai.escort.need) {
-                                thisValue = kMostImportantTarget;
-                            } else {
-                                thisValue = kUnimportantTarget;
-                            }
-                        }
-                    } else {
-                        thisValue = kUnimportantTarget;
-                    }
-                    if (anObject->base->orderFlags & kSoftTargetIsNotBase) {
-                        thisValue <<= 3;
-                    }
-                    if (anObject->base->orderFlags & kHardTargetIsBase) {
-                        thisValue = Fixed::zero();
-                    }
-                }
-                if (anObject->base->orderFlags & kSoftTargetIsFriend) {
-                    thisValue <<= 3;
-                }
-                if (anObject->base->orderFlags & kHardTargetIsFoe) {
-                    thisValue = Fixed::zero();
-                }
-            } else if (destObject->owner.get()) {
-                if ((anObject->duty == eGuardDuty) || (anObject->duty == eNoDuty)) {
-                    if (destObject->attributes & kIsDestination) {
-                        if (foeValue < friendValue) {
-                            thisValue = kMostImportantTarget;
-                        } else {
-                            thisValue = kSomewhatImportantTarget;
-                        }
-                        if (_blitzkrieg > 0) {
-                            thisValue <<= 2;
-                        }
-                        if (anObject->base->orderFlags & kSoftTargetIsBase) {
-                            thisValue <<= 3;
-                        }
-
-                        if (anObject->base->orderFlags & kHardTargetIsNotBase) {
-                            thisValue = Fixed::zero();
-                        }
-                    } else {
-                        if (friendValue != Fixed::zero()) {
-                            if (friendValue < foeValue) {
-                                thisValue = kSomewhatImportantTarget;
-                            } else {
-                                thisValue = kUnimportantTarget;
-                            }
-                        } else {
-                            thisValue = kLeastImportantTarget;
-                        }
-                        if (anObject->base->orderFlags & kSoftTargetIsNotBase) {
-                            thisValue <<= 1;
-                        }
+// Fully reconsiders up to kScoringBatchSize ships per call, each against every possible
+// destination gathered by AdmiralThink(). Each ship is scored against all destinations at once,
+// by ScoringTargets::score(); only the randomization and the choice of the best are done one
+// destination at a time. Random numbers are drawn from each ship’s seed in the order of
+// g.root, so results are deterministic, but they differ from think_incremental().
+void Admiral::think_batched() {
+    if (!_objects.get()) {
+        return;
+    }
 
-                        if (anObject->base->orderFlags & kHardTargetIsBase) {
-                            thisValue = Fixed::zero();
-                        }
-                    }
-                }
-                if (anObject->base->orderFlags & kSoftTargetIsFoe) {
-                    thisValue <<= 3;
-                }
-                if (anObject->base->orderFlags & kHardTargetIsFriend) {
-                    thisValue = Fixed::zero();
-                }
-            } else {
-                if (destObject->attributes & kIsDestination) {
-                    thisValue = kVeryImportantTarget;
-                    if (_blitzkrieg > 0) {
-                        thisValue <<= 2;
-                    }
-                    if (anObject->base->orderFlags & kSoftTargetIsBase) {
-                        thisValue <<= 3;
-                    }
-                    if (anObject->base->orderFlags & kHardTargetIsNotBase) {
-                        thisValue = Fixed::zero();
-                    }
-                } else {
-                    if (anObject->base->orderFlags & kSoftTargetIsNotBase) {
-                        thisValue <<= 3;
-                    }
-                    if (anObject->base->orderFlags & kHardTargetIsBase) {
-                        thisValue = Fixed::zero();
-                    }
-                }
-                if (anObject->base->orderFlags & kSoftTargetIsFoe) {
-                    thisValue <<= 3;
-                }
-                if (anObject->base->orderFlags & kHardTargetIsFriend) {
-                    thisValue = Fixed::zero();
-                }
+    ScoringCandidates& c    = scoring_candidates;
+    auto               ship = _considerShip;
+    if (!ship.get() || (ship->owner.get() != this) || (ship->active != kObjectInUse)) {
+        ship = _objects;
+    }
+    int32_t batch = std::min(kScoringBatchSize, _object_count);
+    for (int32_t i = 0; i < batch; ++i) {
+        if ((ship->attributes & kCanAcceptDestination) && (ship->active == kObjectInUse)) {
+            for (int j = 0; j < c.object.size(); ++j) {
+                c.prefers[j] = prefers_tags(*ship, *c.object[j]);
+                c.forced[j]  = forced_tags(*ship, *c.object[j]);
             }
-
-            difference =
-                    ABS(implicit_cast<int32_t>(destObject->location.h) -
-                        implicit_cast<int32_t>(anObject->location.h));
-            gridLoc.h = difference;
-            difference =
-                    ABS(implicit_cast<int32_t>(destObject->location.v) -
-                        implicit_cast<int32_t>(anObject->location.v));
-            gridLoc.v = difference;
-
-            if ((gridLoc.h < kMaximumRelevantDistance) && (gridLoc.v < kMaximumRelevantDistance)) {
-                if (anObject->base->orderFlags & kSoftTargetIsLocal) {
-                    thisValue <<= 3;
-                }
-                if (anObject->base->orderFlags & kHardTargetIsRemote) {
-                    thisValue = Fixed::zero();
-                }
-            } else {
-                if (anObject->base->orderFlags & kSoftTargetIsRemote) {
-                    thisValue <<= 3;
+            c.targets.score(
+                    scoring_ship(*ship, _blitzkrieg > 0), c.prefers.data(), c.forced.data(),
+                    c.values.data());
+
+            for (int j = 0; j < c.object.size(); ++j) {
+                const auto& dest = c.object[j];
+                if ((dest == ship) || ((ship->owner == dest->owner) &&
+                                       (ship->base->ai.escort.class_ >=
+                                        dest->base->ai.escort.class_))) {
+                    continue;
                 }
-                if (anObject->base->orderFlags & kHardTargetIsLocal) {
-                    thisValue = Fixed::zero();
+                Fixed thisValue = c.values[j];
+                if (thisValue > Fixed::zero()) {
+                    thisValue += ship->randomSeed.next(thisValue >> 1) - (thisValue >> 2);
                 }
-            }
-
-            if (anObject->base->orderFlags & kSoftTargetMatchesTags) {
-                if (tags_match(*destObject->base, anObject->base->ai.target.prefer.tags)) {
-                    thisValue <<= 3;
-                }
-            }
-            if (anObject->base->orderFlags & kHardTargetMatchesTags) {
-                if (!tags_match(*destObject->base, anObject->base->ai.target.force.tags)) {
-                    thisValue = Fixed::zero();
+                if (thisValue > ship->bestConsideredTargetValue) {
+                    ship->bestConsideredTargetValue  = thisValue;
+                    ship->bestConsideredTargetNumber = dest;
                 }
             }
+            decide(ship);
+        }
 
-            if (thisValue > Fixed::zero()) {
-                thisValue += anObject->randomSeed.next(thisValue >> 1) - (thisValue >> 2);
-            }
-            if (thisValue > anObject->bestConsideredTargetValue) {
-                anObject->bestConsideredTargetValue  = thisValue;
-                anObject->bestConsideredTargetNumber = _destinationObject;
-            }
+        ship = ship->nextOwnedObject;
+        if (!ship.get()) {
+            ship                    = _objects;
+            _lastFreeEscortStrength = _thisFreeEscortStrength;
+            _thisFreeEscortStrength = Fixed::zero();
         }
     }
-    think_build();
+    _considerShip   = ship;
+    _considerShipID = ship->id;
 }
 
 void Admiral::think_build() {
@@ -986,11 +998,10 @@ void Admiral::think_build() {
                 // If “needs_escort” is set, don’t build a second object of this type
                 // until the first one has sufficient escorts.
                 auto baseObject = get_buildable_object(*_hopeToBuild, _race);
-                if (baseObject->ai.build.needs_escort) {
-                    for (auto anObject : SpaceObject::all()) {
-                        if ((anObject->active) && (anObject->owner.get() == this) &&
-                            (anObject->base == baseObject) &&
-                            (anObject->escortStrength < baseObject->ai.escort.need)) {
+                if (baseObject->ai.build.needs_escort && object_count(baseObject)) {
+                    for (auto o = _objects; o.get(); o = o->nextOwnedObject) {
+                        if ((o->base == baseObject) &&
+                            (o->escortStrength < baseObject->ai.escort.need)) {
                             _hopeToBuild.reset();
                             break;
                         }
@@ -998,11 +1009,22 @@ void Admiral::think_build() {
                 }
 
                 // Don’t build an object if there are no valid targets for it.
+                // Objects with the same owner are indexed, so only scan those if that’s all
+                // the object can target.
                 bool any_target = false;
-                for (auto anObject : SpaceObject::all()) {
-                    if (anObject->active && could_target(*this, *baseObject, *anObject)) {
-                        any_target = true;
-                        break;
+                if (baseObject->ai.target.force.owner == Owner::SAME) {
+                    for (auto o = _objects; o.get(); o = o->nextOwnedObject) {
+                        if (could_target(*this, *baseObject, *o)) {
+                            any_target = true;
+                            break;
+                        }
+                    }
+                } else {
+                    for (auto anObject : SpaceObject::all()) {
+                        if (anObject->active && could_target(*this, *baseObject, *anObject)) {
+                            any_target = true;
+                            break;
+                        }
                     }
                 }
                 if (!any_target) {
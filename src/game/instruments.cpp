@@ -242,16 +242,14 @@ void UpdateRadar(ticks unitsDone) {
             Point* end    = lp + kRadarBlipNum;
             g.radar_count = kRadarSpeed;
 
-            const int32_t rrange = kRadarRange >> 1L;
-            for (auto anObject : SpaceObject::all()) {
-                if (!anObject->active || (anObject == g.ship)) {
-                    continue;
-                }
-                int x = anObject->location.h - g.ship->location.h;
-                int y = anObject->location.v - g.ship->location.v;
-                if ((x < -rrange) || (x >= rrange) || (y < -rrange) || (y >= rrange)) {
-                    continue;
-                }
+            const int32_t     rrange = kRadarRange >> 1L;
+            SpaceObjectFilter filter;
+            filter.exclude = g.ship;
+            Rect range(-rrange, -rrange, rrange, rrange);
+            range.offset(g.ship->location.h, g.ship->location.v);
+            for (auto anObject : objects_in_rect(range, filter)) {
+                int   x = anObject->location.h - g.ship->location.h;
+                int   y = anObject->location.v - g.ship->location.v;
                 Point p(x * kRadarSize / kRadarRange, y * kRadarSize / kRadarRange);
                 p.offset(kRadarCenter + kRadarLeft, kRadarCenter + kRadarTop + instrument_top());
                 if (!radar.contains(p)) {
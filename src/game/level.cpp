@@ -18,6 +18,7 @@
 
 #include "game/level.hpp"
 
+#include <algorithm>
 #include <set>
 #include <sfz/sfz.hpp>
 
@@ -93,7 +94,7 @@ void AddBaseObjectMedia(
     }
     for (int i = 0; i < 16; ++i) {
         if (colors[i] && sprite_resource(*base).has_value()) {
-            sys.pix.add(*sprite_resource(*base), Hue(i));
+            sys.pix.request(*sprite_resource(*base), Hue(i));
         }
     }
 
@@ -132,10 +133,10 @@ void AddActionMedia(const Action& action, std::bitset<16> all_colors) {
 
         case Action::Type::PLAY:
             if (action.play.sound.has_value()) {
-                sys.sound.load(*action.play.sound);
+                sys.sound.request(*action.play.sound);
             } else {
                 for (const auto& s : action.play.any) {
-                    sys.sound.load(s.sound);
+                    sys.sound.request(s.sound);
                 }
             }
             break;
@@ -193,8 +194,8 @@ LoadState start_construct_level(const Level& level) {
     Admiral::reset();
     ResetAllDestObjectData();
     ResetMotionGlobals();
-    plug.races.clear();
-    plug.objects.clear();
+    unload_races();
+    unload_objects();
     gAbsoluteScale = kTimesTwoScale;
     g.sync         = 0;
 
@@ -231,7 +232,7 @@ LoadState start_construct_level(const Level& level) {
     sys.sound.reset();
 
     LoadState s;
-    s.max = Initial::all().size() * 3L + 1 +
+    s.max = Initial::all().size() * 3L + 3 +
             g.level->base.start_time.value_or(secs(0))
                     .count();  // for each run through the initial num
 
@@ -269,9 +270,9 @@ static void load_initial(Handle<const Initial> initial, std::bitset<16> all_colo
     // make sure we're not overriding the sprite
     if (initial->override_.sprite.has_value()) {
         if (baseObject->attributes & kCanThink) {
-            sys.pix.add(*initial->override_.sprite, GetAdmiralColor(owner));
+            sys.pix.request(*initial->override_.sprite, GetAdmiralColor(owner));
         } else {
-            sys.pix.add(*initial->override_.sprite, Hue::GRAY);
+            sys.pix.request(*initial->override_.sprite, Hue::GRAY);
         }
     }
 
@@ -313,6 +314,7 @@ static void run_game_1s() {
 }
 
 void construct_level(LoadState* state) {
+    const int32_t   n    = Initial::all().size();
     int32_t         step = state->step;
     std::bitset<16> all_colors;
     all_colors[0] = true;
@@ -325,23 +327,31 @@ void construct_level(LoadState* state) {
     if (step == 0) {
         load_blessed_objects(all_colors);
         load_initial(Handle<const Initial>(step), all_colors);
-    } else if (step < Initial::all().size()) {
+    } else if (step < n) {
         load_initial(Handle<const Initial>(step), all_colors);
-    } else if (step == Initial::all().size()) {
+    } else if (step == n) {
         // add media for all condition actions
-        step -= Initial::all().size();
         for (auto c : Condition::all()) {
             load_condition(c, all_colors);
         }
+    } else if (step == (n + 1)) {
+        // sprites and sounds are decoded by worker threads; upload them as they finish, and stay
+        // on this step until all have.
+        int decoding    = sys.pix.upload() + sys.sound.upload();
+        int requested   = sys.pix.requested() + sys.sound.requested();
+        state->fraction = 1.0 - (decoding / std::max(1.0, double(requested)));
+        if (decoding > 0) {
+            return;
+        }
+        state->fraction = 0.0;
+    } else if (step < ((2 * n) + 2)) {
+        step -= n + 2;
         create_initial(Handle<const Initial>(step));
-    } else if (step < (2 * Initial::all().size())) {
-        step -= Initial::all().size();
-        create_initial(Handle<const Initial>(step));
-    } else if (step < (3 * Initial::all().size())) {
+    } else if (step < ((3 * n) + 2)) {
         // double back and set up any defined initial destinations
-        step -= (2 * Initial::all().size());
+        step -= (2 * n) + 2;
         set_initial_destination(Handle<const Initial>(step), false);
-    } else if (step == (3 * Initial::all().size())) {
+    } else if (step == ((3 * n) + 2)) {
         RecalcAllAdmiralBuildData();  // set up all the admiral's destination objects
         Messages::clear();
         g.time = game_ticks(-g.level->base.start_time.value_or(secs(0)));
@@ -18,6 +18,10 @@
 
 #include "game/motion.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
 #include "data/base-object.hpp"
 #include "drawing/color.hpp"
 #include "drawing/pix-table.hpp"
@@ -400,6 +404,7 @@ void MoveSpaceObjects(const ticks unitsToDo) {
     if (unitsToDo == ticks(0)) {
         return;
     }
+    invalidate_object_grid();
 
     for (ticks jl = ticks(0); jl < unitsToDo; jl++) {
         SpaceObject* o = nullptr;
@@ -758,13 +763,65 @@ static void calc_impacts(Handle<SpaceObject> near_objects[PROXIMITY_GRID_AREA])
     }
 }
 
+static ANTARES_GLOBAL Locality        locality        = Locality::PAIRWISE;
+static ANTARES_GLOBAL LocalityReport* locality_report = nullptr;
+
+void set_locality(Locality l) { locality = l; }
+void set_locality_report(LocalityReport* report) { locality_report = report; }
+
+static bool considers_foes(const SpaceObject& o) {
+    return o.attributes & (kCanThink | kRemoteOrHuman | kHated);
+}
+
+// Compares `a` and `b`, which have different owners and both consider foes. Sets closestObject,
+// closestDistance, seenByPlayerFlags and kIsHidden.
+static void compare_foes(
+        Handle<SpaceObject> a_handle, SpaceObject* a, Handle<SpaceObject> b_handle,
+        SpaceObject* b) {
+    uint32_t x_dist = ABS<int>(b->location.h - a->location.h);
+    uint32_t y_dist = ABS<int>(b->location.v - a->location.v);
+    uint32_t dist;
+    if ((x_dist > kMaximumRelevantDistance) || (y_dist > kMaximumRelevantDistance)) {
+        dist = kMaximumRelevantDistanceSquared;
+    } else {
+        dist = (y_dist * y_dist) + (x_dist * x_dist);
+    }
+
+    if (dist < kMaximumRelevantDistanceSquared) {
+        a->seenByPlayerFlags |= b->myPlayerFlag;
+        b->seenByPlayerFlags |= a->myPlayerFlag;
+
+        if (b->attributes & kHideEffect) {
+            a->runTimeFlags |= kIsHidden;
+        }
+
+        if (a->attributes & kHideEffect) {
+            b->runTimeFlags |= kIsHidden;
+        }
+    }
+
+    if (a->engages(*b)) {
+        if ((dist < a->closestDistance) && (b->attributes & kPotentialTarget)) {
+            a->closestDistance = dist;
+            a->closestObject   = b_handle;
+        }
+    }
+
+    if (b->engages(*a)) {
+        if ((dist < b->closestDistance) && (a->attributes & kPotentialTarget)) {
+            b->closestDistance = dist;
+            b->closestObject   = a_handle;
+        }
+    }
+}
+
 // Sets the following properties on objects:
 //   * closestObject
 //   * closestDistance
 //   * localFriendStrength
 //   * localFoeStrength
 // Also sets seenByPlayerFlags and kIsHidden based on object proximity.
-static void calc_locality(Handle<SpaceObject> far_objects[PROXIMITY_GRID_AREA]) {
+static void calc_pairwise_locality(Handle<SpaceObject> far_objects[PROXIMITY_GRID_AREA]) {
     for (int32_t i = 0; i < PROXIMITY_GRID_AREA; i++) {
         const auto*  cells = kAdjacentCells.at[i];
         SpaceObject* a     = nullptr;
@@ -783,50 +840,8 @@ static void calc_locality(Handle<SpaceObject> far_objects[PROXIMITY_GRID_AREA])
                     if (b->distanceGrid != super) {
                         continue;
                     }
-                    if ((b->owner != a->owner) &&
-                        ((b->attributes & kCanThink) || (b->attributes & kRemoteOrHuman) ||
-                         (b->attributes & kHated)) &&
-                        ((a->attributes & kCanThink) || (a->attributes & kRemoteOrHuman) ||
-                         (a->attributes & kHated))) {
-                        uint32_t x_dist = ABS<int>(b->location.h - a->location.h);
-                        uint32_t y_dist = ABS<int>(b->location.v - a->location.v);
-                        uint32_t dist;
-                        if ((x_dist > kMaximumRelevantDistance) ||
-                            (y_dist > kMaximumRelevantDistance)) {
-                            dist = kMaximumRelevantDistanceSquared;
-                        } else {
-                            dist = (y_dist * y_dist) + (x_dist * x_dist);
-                        }
-
-                        if (dist < kMaximumRelevantDistanceSquared) {
-                            a->seenByPlayerFlags |= b->myPlayerFlag;
-                            b->seenByPlayerFlags |= a->myPlayerFlag;
-
-                            if (b->attributes & kHideEffect) {
-                                a->runTimeFlags |= kIsHidden;
-                            }
-
-                            if (a->attributes & kHideEffect) {
-                                b->runTimeFlags |= kIsHidden;
-                            }
-                        }
-
-                        if (a->engages(*b)) {
-                            if ((dist < a->closestDistance) &&
-                                (b->attributes & kPotentialTarget)) {
-                                a->closestDistance = dist;
-                                a->closestObject   = b_handle;
-                            }
-                        }
-
-                        if (b->engages(*a)) {
-                            if ((dist < b->closestDistance) &&
-                                (a->attributes & kPotentialTarget)) {
-                                b->closestDistance = dist;
-                                b->closestObject   = a_handle;
-                            }
-                        }
-
+                    if ((b->owner != a->owner) && considers_foes(*b) && considers_foes(*a)) {
+                        compare_foes(a_handle, a, b_handle, b);
                         b->localFoeStrength += a->localFriendStrength;
                         b->localFriendStrength += a->localFoeStrength;
                     } else if (k == 0) {
@@ -844,12 +859,149 @@ static void calc_locality(Handle<SpaceObject> far_objects[PROXIMITY_GRID_AREA])
     }
 }
 
+// Like calc_pairwise_locality(), but leaves strength alone. Only objects that consider foes are
+// compared, so dense groups of shots and allied ships cost nothing. Pairs are visited in the
+// same order, so closestObject comes out the same.
+static ANTARES_GLOBAL std::vector<Handle<SpaceObject>> thinking_objects[PROXIMITY_GRID_AREA];
+
+static void calc_proximity(Handle<SpaceObject> far_objects[PROXIMITY_GRID_AREA]) {
+    for (int32_t i = 0; i < PROXIMITY_GRID_AREA; i++) {
+        thinking_objects[i].clear();
+        SpaceObject* o = nullptr;
+        for (auto o_handle = far_objects[i]; (o = o_handle.get()); o_handle = o->nextFarObject) {
+            if (considers_foes(*o)) {
+                thinking_objects[i].push_back(o_handle);
+            }
+        }
+    }
+
+    for (int32_t i = 0; i < PROXIMITY_GRID_AREA; i++) {
+        const auto* cells = kAdjacentCells.at[i];
+        const auto& here  = thinking_objects[i];
+        for (size_t j = 0; j < here.size(); ++j) {
+            Handle<SpaceObject> a_handle = here[j];
+            SpaceObject*        a        = a_handle.get();
+            for (int32_t k = 0; k < AdjacentCells::size; k++) {
+                const auto* there = &here;
+                size_t      first = j + 1;
+                Point       super = a->distanceGrid;
+                if (k > 0) {
+                    const auto& adj = cells[k];
+                    there           = &thinking_objects[adj.index_offset];
+                    first           = 0;
+                    super.offset(adj.super_offset.h, adj.super_offset.v);
+                }
+
+                for (size_t l = first; l < there->size(); ++l) {
+                    Handle<SpaceObject> b_handle = (*there)[l];
+                    SpaceObject*        b        = b_handle.get();
+                    if ((b->distanceGrid != super) || (b->owner == a->owner)) {
+                        continue;
+                    }
+                    compare_foes(a_handle, a, b_handle, b);
+                }
+            }
+        }
+    }
+}
+
+// Strength of each owner within one far-grid cell, indexed by owner number + 1 (0 is unowned).
+// Cells are keyed by collisionGrid, so unlike far_objects, distant cells never alias.
+struct Influence {
+    Fixed strength[kMaxPlayerNum + 1];
+};
+static ANTARES_GLOBAL std::unordered_map<uint64_t, Influence> influence_map;
+
+static uint64_t influence_key(int32_t h, int32_t v) {
+    return (uint64_t(uint32_t(h)) << 32) | uint32_t(v);
+}
+
+static size_t influence_index(const SpaceObject& o) { return o.owner.number() + 1; }
+
+// Calls fn(o, friend_strength, foe_strength) for each object in far_objects, with strength
+// summed from the influence map over the 3x3 cells around `o`. Friend strength includes `o`.
+template <typename Fn>
+static void sample_influence(Handle<SpaceObject> far_objects[PROXIMITY_GRID_AREA], Fn fn) {
+    influence_map.clear();
+    for (int32_t i = 0; i < PROXIMITY_GRID_AREA; i++) {
+        SpaceObject* o = nullptr;
+        for (auto o_handle = far_objects[i]; (o = o_handle.get()); o_handle = o->nextFarObject) {
+            auto key = influence_key(o->collisionGrid.h, o->collisionGrid.v);
+            auto it  = influence_map.find(key);
+            if (it == influence_map.end()) {
+                Influence empty;
+                std::fill(empty.strength, empty.strength + kMaxPlayerNum + 1, Fixed::zero());
+                it = influence_map.emplace(key, empty).first;
+            }
+            it->second.strength[influence_index(*o)] += o->base->ai.escort.power;
+        }
+    }
+
+    for (int32_t i = 0; i < PROXIMITY_GRID_AREA; i++) {
+        SpaceObject* o = nullptr;
+        for (auto o_handle = far_objects[i]; (o = o_handle.get()); o_handle = o->nextFarObject) {
+            Fixed friends = Fixed::zero();
+            Fixed foes    = Fixed::zero();
+            for (int32_t dv = -1; dv <= 1; ++dv) {
+                for (int32_t dh = -1; dh <= 1; ++dh) {
+                    auto it = influence_map.find(
+                            influence_key(o->collisionGrid.h + dh, o->collisionGrid.v + dv));
+                    if (it == influence_map.end()) {
+                        continue;
+                    }
+                    for (size_t owner = 0; owner <= kMaxPlayerNum; ++owner) {
+                        if (owner == influence_index(*o)) {
+                            friends += it->second.strength[owner];
+                        } else {
+                            foes += it->second.strength[owner];
+                        }
+                    }
+                }
+            }
+            fn(o, friends, foes);
+        }
+    }
+}
+
+static void report_locality(Handle<SpaceObject> far_objects[PROXIMITY_GRID_AREA]) {
+    sample_influence(far_objects, [](SpaceObject* o, Fixed friends, Fixed foes) {
+        auto&  r            = *locality_report;
+        double friend_error = std::abs((friends - o->localFriendStrength).val() / 256.0);
+        double foe_error    = std::abs((foes - o->localFoeStrength).val() / 256.0);
+        ++r.samples;
+        if ((friend_error == 0) && (foe_error == 0)) {
+            ++r.exact;
+        }
+        r.friend_total += std::abs(o->localFriendStrength.val() / 256.0);
+        r.friend_error += friend_error;
+        r.foe_total += std::abs(o->localFoeStrength.val() / 256.0);
+        r.foe_error += foe_error;
+    });
+}
+
+static void calc_locality(Handle<SpaceObject> far_objects[PROXIMITY_GRID_AREA]) {
+    if (locality_report) {
+        calc_pairwise_locality(far_objects);
+        report_locality(far_objects);
+    } else if (locality == Locality::PAIRWISE) {
+        calc_pairwise_locality(far_objects);
+    } else {
+        calc_proximity(far_objects);
+        sample_influence(far_objects, [](SpaceObject* o, Fixed friends, Fixed foes) {
+            o->localFriendStrength = friends;
+            o->localFoeStrength    = foes;
+        });
+    }
+}
+
 static void calc_visibility() {
-    // here, it doesn't matter in what order we step through the table
+    // here, it doesn't matter in what order we step through the table. Every object that is not
+    // kObjectAvailable is in g.root, so there's no need to scan the rest.
     const uint32_t seen_by_me = 1ul << g.admiral.number();
 
-    for (auto o_handle : SpaceObject::all()) {
-        SpaceObject* o = o_handle.get();
+    SpaceObject* o = nullptr;
+    for (auto o_handle = g.root; (o = o_handle.get());) {
+        o_handle = o->nextObject;  // before free() unlinks `o`.
         if (o->active == kObjectToBeFreed) {
             o->free();
         } else if (o->active) {
@@ -889,6 +1041,148 @@ void CollideSpaceObjects() {
     calc_locality(far_objects);
     calc_visibility();
     update_last_vector_locations();
+    invalidate_object_grid();  // correct_physical_space() and actions may move objects.
+}
+
+namespace {
+
+// Like far_objects, but covering all objects in g.root rather than only those that consider
+// distance. Cells are SECTOR_MEDIUM wide, so the grid wraps every SECTOR_HUGE; objects from
+// different super-cells share a cell, and queries filter them out by exact location.
+struct ObjectGrid {
+    std::vector<Handle<SpaceObject>> cells[PROXIMITY_GRID_AREA];
+    bool                             valid = false;
+
+    void build() {
+        for (auto& cell : cells) {
+            cell.clear();
+        }
+        SpaceObject* o = nullptr;
+        for (auto o_handle = g.root; (o = o_handle.get()); o_handle = o->nextObject) {
+            cells[proximity_index(
+                          (o->location.h / SECTOR_MEDIUM) & PROXIMITY_GRID_MASK,
+                          (o->location.v / SECTOR_MEDIUM) & PROXIMITY_GRID_MASK)]
+                    .push_back(o_handle);
+        }
+        valid = true;
+    }
+
+    // Calls `fn` for each object in a cell overlapping `r`, in no particular order.
+    template <typename F>
+    void for_each(Rect r, F fn) {
+        if (!valid) {
+            build();
+        }
+        int32_t left   = r.left / SECTOR_MEDIUM;
+        int32_t top    = r.top / SECTOR_MEDIUM;
+        int32_t right  = std::min(left + PROXIMITY_GRID_WIDTH, (r.right - 1) / SECTOR_MEDIUM + 1);
+        int32_t bottom = std::min(top + PROXIMITY_GRID_WIDTH, (r.bottom - 1) / SECTOR_MEDIUM + 1);
+        for (int32_t y = top; y < bottom; ++y) {
+            for (int32_t x = left; x < right; ++x) {
+                const auto& cell =
+                        cells[proximity_index(x & PROXIMITY_GRID_MASK, y & PROXIMITY_GRID_MASK)];
+                for (auto o : cell) {
+                    fn(o);
+                }
+            }
+        }
+    }
+};
+
+static ANTARES_GLOBAL ObjectGrid object_grid;
+
+static bool matches(const SpaceObjectFilter& filter, Handle<SpaceObject> o) {
+    return (o->active != kObjectAvailable) && (o != filter.exclude) &&
+           (!filter.attributes || (o->attributes & filter.attributes)) &&
+           (!filter.owner.has_value() || (o->owner == *filter.owner));
+}
+
+static uint64_t distance_squared(Point a, Point b) {
+    uint64_t h = ABS<int64_t>(int64_t{a.h} - b.h);
+    uint64_t v = ABS<int64_t>(int64_t{a.v} - b.v);
+    return (h * h) + (v * v);
+}
+
+static bool by_number(Handle<SpaceObject> a, Handle<SpaceObject> b) {
+    return a.number() < b.number();
+}
+
+static bool by_distance(
+        const std::pair<uint64_t, Handle<SpaceObject>>& a,
+        const std::pair<uint64_t, Handle<SpaceObject>>& b) {
+    return (a.first != b.first) ? (a.first < b.first) : by_number(a.second, b.second);
+}
+
+}  // namespace
+
+void invalidate_object_grid() { object_grid.valid = false; }
+
+std::vector<Handle<SpaceObject>> objects_in_rect(Rect r, const SpaceObjectFilter& filter) {
+    std::vector<Handle<SpaceObject>> result;
+    if (r.empty()) {
+        return result;
+    }
+    object_grid.for_each(r, [&r, &filter, &result](Handle<SpaceObject> o) {
+        if (matches(filter, o) && r.contains(o->location)) {
+            result.push_back(o);
+        }
+    });
+    std::sort(result.begin(), result.end(), by_number);
+    return result;
+}
+
+std::vector<Handle<SpaceObject>> objects_in_radius(
+        Point center, int32_t radius, const SpaceObjectFilter& filter) {
+    std::vector<Handle<SpaceObject>> result;
+    if (radius < 0) {
+        return result;
+    }
+    const uint64_t r2 = uint64_t{static_cast<uint32_t>(radius)} * radius;
+    Rect           bounds(center.h - radius, center.v - radius, center.h + radius + 1,
+                          center.v + radius + 1);
+    object_grid.for_each(bounds, [center, r2, &filter, &result](Handle<SpaceObject> o) {
+        if (matches(filter, o) && (distance_squared(center, o->location) <= r2)) {
+            result.push_back(o);
+        }
+    });
+    std::sort(result.begin(), result.end(), by_number);
+    return result;
+}
+
+std::vector<Handle<SpaceObject>> nearest_objects(
+        Point center, int count, const SpaceObjectFilter& filter) {
+    std::vector<std::pair<uint64_t, Handle<SpaceObject>>> found;
+    if (count <= 0) {
+        return {};
+    }
+
+    // Search squares of cells of increasing size around `center`. Once `count` objects are
+    // found within the inscribed circle of the square, no object outside it can be nearer. The
+    // last square covers the whole grid, and so every object.
+    for (int32_t ring = 0; ring <= PROXIMITY_GRID_WIDTH / 2; ++ring) {
+        int32_t left = ((center.h / SECTOR_MEDIUM) - ring) * SECTOR_MEDIUM;
+        int32_t top  = ((center.v / SECTOR_MEDIUM) - ring) * SECTOR_MEDIUM;
+        int32_t size = ((2 * ring) + 1) * SECTOR_MEDIUM;
+        found.clear();
+        object_grid.for_each(
+                Rect(left, top, left + size, top + size),
+                [center, &filter, &found](Handle<SpaceObject> o) {
+                    if (matches(filter, o)) {
+                        found.emplace_back(distance_squared(center, o->location), o);
+                    }
+                });
+        std::sort(found.begin(), found.end(), by_distance);
+        uint64_t reach = uint64_t{static_cast<uint32_t>(ring)} * SECTOR_MEDIUM;
+        if ((found.size() >= count) && (found[count - 1].first <= (reach * reach))) {
+            break;
+        }
+    }
+
+    std::vector<Handle<SpaceObject>> result;
+    for (int i = 0; (i < count) && (i < found.size()); ++i) {
+        result.push_back(found[i].second);
+    }
+    return result;
 }
 
 static void adjust_velocity(SpaceObject* o, int16_t angle, Fixed totalMass, Fixed force) {
@@ -0,0 +1,199 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2008-2017 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include "game/motion.hpp"
+
+#include <gmock/gmock.h>
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "game/admiral.hpp"
+#include "game/globals.hpp"
+#include "game/space-object.hpp"
+
+using testing::ContainerEq;
+
+namespace antares {
+namespace {
+
+const int kObjects = 1000;
+const int kQueries = 200;
+
+class MotionQueryTest : public testing::Test {
+  protected:
+    // Coordinates span several wraps of the object grid, so that objects far apart often share
+    // a cell, and cluster near the center, so that objects are often at equal distances.
+    int32_t coordinate() {
+        switch (_random() % 4) {
+            case 0: return kUniversalCenter + static_cast<int32_t>(_random() % 64) - 32;
+            default:
+                return kUniversalCenter + static_cast<int32_t>(_random() % (4 * SECTOR_HUGE)) -
+                       (2 * SECTOR_HUGE);
+        }
+    }
+
+    Point point() { return Point(coordinate(), coordinate()); }
+
+    SpaceObjectFilter filter() {
+        SpaceObjectFilter result;
+        switch (_random() % 4) {
+            case 0: result.attributes = kCanThink | kIsVector; break;
+            case 1: result.attributes = kCanBeEngaged; break;
+        }
+        if (_random() % 2) {
+            result.owner.emplace(Handle<Admiral>(static_cast<int>(_random() % 3) - 1));
+        }
+        if (_random() % 2) {
+            result.exclude = Handle<SpaceObject>(_random() % kObjects);
+        }
+        return result;
+    }
+
+    void SetUp() override {
+        SpaceObjectHandlingInit();
+        for (int i = 0; i < kObjects; ++i) {
+            Handle<SpaceObject> o(i);
+            switch (_random() % 8) {
+                case 0: continue;  // Left kObjectAvailable.
+                case 1: o->active = kObjectToBeFreed; break;
+                default: o->active = kObjectInUse; break;
+            }
+            o->location   = point();
+            o->owner      = Handle<Admiral>(static_cast<int>(_random() % 3) - 1);
+            o->attributes = 0;
+            for (uint32_t attribute : {kCanThink, kIsVector, kCanBeEngaged}) {
+                if (_random() % 2) {
+                    o->attributes |= attribute;
+                }
+            }
+            o->nextObject     = g.root;
+            o->previousObject = SpaceObject::none();
+            if (g.root.get()) {
+                g.root->previousObject = o;
+            }
+            g.root = o;
+        }
+        invalidate_object_grid();
+    }
+
+    void TearDown() override {
+        ResetAllSpaceObjects();
+        invalidate_object_grid();
+    }
+
+    // Brute-force counterparts of the grid queries.
+    static bool matches(const SpaceObjectFilter& filter, Handle<SpaceObject> o) {
+        return (o->active != kObjectAvailable) && (o != filter.exclude) &&
+               (!filter.attributes || (o->attributes & filter.attributes)) &&
+               (!filter.owner.has_value() || (o->owner == *filter.owner));
+    }
+
+    static int64_t distance_squared(Point a, Point b) {
+        int64_t h = int64_t{a.h} - b.h;
+        int64_t v = int64_t{a.v} - b.v;
+        return (h * h) + (v * v);
+    }
+
+    static std::vector<Handle<SpaceObject>> scan_rect(Rect r, const SpaceObjectFilter& filter) {
+        std::vector<Handle<SpaceObject>> result;
+        for (auto o : SpaceObject::all()) {
+            if (matches(filter, o) && r.contains(o->location)) {
+                result.push_back(o);
+            }
+        }
+        return result;
+    }
+
+    static std::vector<Handle<SpaceObject>> scan_radius(
+            Point center, int32_t radius, const SpaceObjectFilter& filter) {
+        std::vector<Handle<SpaceObject>> result;
+        for (auto o : SpaceObject::all()) {
+            if (matches(filter, o) &&
+                (distance_squared(center, o->location) <= (int64_t{radius} * radius))) {
+                result.push_back(o);
+            }
+        }
+        return result;
+    }
+
+    static std::vector<Handle<SpaceObject>> scan_nearest(
+            Point center, int count, const SpaceObjectFilter& filter) {
+        std::vector<std::pair<int64_t, int>> found;
+        for (auto o : SpaceObject::all()) {
+            if (matches(filter, o)) {
+                found.emplace_back(distance_squared(center, o->location), o.number());
+            }
+        }
+        std::sort(found.begin(), found.end());
+        std::vector<Handle<SpaceObject>> result;
+        for (int i = 0; (i < count) && (i < found.size()); ++i) {
+            result.push_back(Handle<SpaceObject>(found[i].second));
+        }
+        return result;
+    }
+
+    std::mt19937 _random;
+};
+
+TEST_F(MotionQueryTest, Rect) {
+    for (int i = 0; i < kQueries; ++i) {
+        Point             a = point(), b = point();
+        Rect              r(std::min(a.h, b.h), std::min(a.v, b.v), std::max(a.h, b.h),
+                            std::max(a.v, b.v));
+        SpaceObjectFilter f = filter();
+        EXPECT_THAT(objects_in_rect(r, f), ContainerEq(scan_rect(r, f)));
+    }
+}
+
+TEST_F(MotionQueryTest, Radius) {
+    for (int i = 0; i < kQueries; ++i) {
+        Point             center = point();
+        int32_t           radius = _random() % (2 * SECTOR_HUGE);
+        SpaceObjectFilter f      = filter();
+        EXPECT_THAT(
+                objects_in_radius(center, radius, f), ContainerEq(scan_radius(center, radius, f)));
+    }
+}
+
+TEST_F(MotionQueryTest, Nearest) {
+    for (int i = 0; i < kQueries; ++i) {
+        Point             center = point();
+        int               count  = _random() % 40;
+        SpaceObjectFilter f      = filter();
+        EXPECT_THAT(
+                nearest_objects(center, count, f), ContainerEq(scan_nearest(center, count, f)));
+    }
+}
+
+// Queries see objects at their new locations once the grid is invalidated.
+TEST_F(MotionQueryTest, Moved) {
+    for (int i = 0; i < kQueries; ++i) {
+        Handle<SpaceObject> o(_random() % kObjects);
+        o->location = point();
+        invalidate_object_grid();
+
+        Point             center = point();
+        SpaceObjectFilter f      = filter();
+        EXPECT_THAT(nearest_objects(center, 5, f), ContainerEq(scan_nearest(center, 5, f)));
+    }
+}
+
+}  // namespace
+}  // namespace antares
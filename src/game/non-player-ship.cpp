@@ -1460,8 +1460,21 @@ Handle<SpaceObject> GetSpritePointSelectObject(
         Handle<SpaceObject> currentShip, Allegiance allegiance) {
     const uint32_t myOwnerFlag = 1 << sourceObject->owner.number();
 
+    // Sprites are placed by scale_to_viewport(), so query the area of the world that maps to
+    // `bounds`, with some slack for rounding and for objects moved since their sprites were.
+    const int32_t slack    = SECTOR_SMALL + (SCALE_SCALE / scaled_screen.scale) + 1;
+    auto          to_world = [](int32_t screen, int32_t viewport_origin, int32_t world_origin) {
+        return world_origin +
+               ((screen - viewport_origin) * SCALE_SCALE.factor / scaled_screen.scale.factor);
+    };
+    Rect world(
+            to_world(bounds->left, viewport().left, scaled_screen.bounds.left) - slack,
+            to_world(bounds->top, viewport().top, scaled_screen.bounds.top) - slack,
+            to_world(bounds->right, viewport().left, scaled_screen.bounds.left) + slack,
+            to_world(bounds->bottom, viewport().top, scaled_screen.bounds.top) + slack);
+
     Handle<SpaceObject> resultShip, closestShip;
-    for (auto anObject : SpaceObject::all()) {
+    for (auto anObject : objects_in_rect(world, SpaceObjectFilter{})) {
         if (!anObject->active || !anObject->sprite.get() ||
             !(anObject->seenByPlayerFlags & myOwnerFlag) ||
             ((anyOneAttribute != 0) && ((anObject->attributes & anyOneAttribute) == 0)) ||
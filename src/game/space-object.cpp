@@ -72,20 +72,58 @@ void SpaceObjectHandlingInit() {
     reset_action_queue();
 }
 
+static void reset_object_index() {
+    invalidate_object_grid();
+    g.object_count = 0;
+    g.base_counts.clear();
+    if (g.admirals) {
+        for (auto a : Admiral::all()) {
+            while (a->objects().get()) {
+                a->remove_object(a->objects());
+            }
+        }
+    }
+}
+
+// Counts `o` and links it into its owner's list. Should be called whenever `o` stops being
+// kObjectAvailable, or after its owner or base changes.
+static void index_object(Handle<SpaceObject> o) {
+    invalidate_object_grid();
+    ++g.object_count;
+    ++g.base_counts[o->base];
+    if (o->owner.get()) {
+        o->owner->add_object(o);
+    }
+}
+
+// Reverses index_object(). Must be called before changing the owner or base of `o`.
+static void unindex_object(Handle<SpaceObject> o) {
+    invalidate_object_grid();
+    --g.object_count;
+    auto it = g.base_counts.find(o->base);
+    if ((it != g.base_counts.end()) && (--it->second == 0)) {
+        g.base_counts.erase(it);
+    }
+    if (o->owner.get()) {
+        o->owner->remove_object(o);
+    }
+}
+
 void ResetAllSpaceObjects() {
     g.root = SpaceObject::none();
     for (auto anObject : SpaceObject::all()) {
         anObject->active = kObjectAvailable;
         anObject->sprite = Sprite::none();
     }
+    reset_object_index();
 }
 
 BaseObject* BaseObject::get(int number) { return get(pn::dump(number, pn::dump_short)); }
 
 BaseObject* BaseObject::get(pn::string_view name) {
     auto it = plug.objects.find(name.copy());
-    if (it != plug.objects.end()) {
-        return &it->second;
+    if ((it != plug.objects.end()) && it->second.loaded) {
+        return &it->second.value;
     }
     return nullptr;
 }
@@ -200,6 +238,7 @@ static Handle<SpaceObject> AddSpaceObject(SpaceObject* sourceObject) {
         g.root->previousObject = obj;
     }
     g.root = obj;
+    index_object(obj);
 
     return obj;
 }
@@ -214,6 +253,7 @@ void RemoveAllSpaceObjects() {
         obj->nextNearObject = obj->nextFarObject = SpaceObject::none();
         obj->attributes                          = 0;
     }
+    reset_object_index();
 }
 
 SpaceObject::SpaceObject(
@@ -376,6 +416,9 @@ void SpaceObject::change_base_type(
     int32_t       r;
     NatePixTable* spriteTable;
 
+    if (obj->active != kObjectAvailable) {
+        unindex_object(Handle<SpaceObject>(number()));
+    }
     obj->attributes  = base.attributes | (obj->attributes & (kIsPlayerShip | kStaticDestination));
     obj->base        = &base;
     obj->icon        = base.icon;
@@ -421,6 +464,7 @@ void SpaceObject::change_base_type(
     // not setting id
 
     obj->active = kObjectInUse;
+    index_object(Handle<SpaceObject>(number()));
 
     // not setting sprite, targetObjectNumber, lastTarget, lastTargetDistance;
 
@@ -532,14 +576,13 @@ Handle<SpaceObject> CreateAnySpaceObject(
 }
 
 int32_t CountObjectsOfBaseType(const BaseObject* whichType, Handle<Admiral> owner) {
-    int32_t result = 0;
-    for (auto anObject : SpaceObject::all()) {
-        if (anObject->active && (!whichType || (anObject->base == whichType)) &&
-            (!owner.get() || (anObject->owner == owner))) {
-            ++result;
-        }
+    if (owner.get()) {
+        return owner->object_count(whichType);
+    } else if (whichType) {
+        auto it = g.base_counts.find(whichType);
+        return (it == g.base_counts.end()) ? 0 : it->second;
     }
-    return result;
+    return g.object_count;
 }
 
 void SpaceObject::alter_health(int32_t amount) {
@@ -604,7 +647,13 @@ void SpaceObject::set_owner(Handle<Admiral> new_owner, bool message) {
     }
 
     Handle<Admiral> old_owner = object->owner;
-    object->owner             = new_owner;
+    if (object->active != kObjectAvailable) {
+        unindex_object(object);
+        object->owner = new_owner;
+        index_object(object);
+    } else {
+        object->owner = new_owner;
+    }
 
     if (new_owner.get() && (object->attributes & kIsDestination)) {
         if (!new_owner->control().get()) {
@@ -757,6 +806,9 @@ void SpaceObject::destroy() {
 }
 
 void SpaceObject::free() {
+    if (active != kObjectAvailable) {
+        unindex_object(Handle<SpaceObject>(number()));
+    }
     if (attributes & kIsVector) {
         if (frame.vector.get()) {
             frame.vector->killMe = true;
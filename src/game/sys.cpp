@@ -53,8 +53,6 @@ void sys_init() {
     sys.gamepad_names      = Resource::strings(Gamepad::kNameStrings);
     sys.gamepad_long_names = Resource::strings(Gamepad::kLongNameStrings);
 
-    sys.rot_table = Resource::rotation_table();
-
     sys.messages     = Resource::strings(kMessageStrings);
     sys.minicomputer = Resource::strings(kMinicomputerStrings);
     sys.cheat.codes  = Resource::strings(kCheatStrings);
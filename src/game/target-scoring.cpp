@@ -0,0 +1,349 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2008-2017 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include "game/target-scoring.hpp"
+
+#include "data/base-object.hpp"
+#include "math/macros.hpp"
+#include "math/units.hpp"
+
+namespace antares {
+
+static const Fixed kUnimportantTarget       = Fixed::from_float(0.000);
+static const Fixed kMostImportantTarget     = Fixed::from_float(2.000);
+static const Fixed kLeastImportantTarget    = Fixed::from_float(1.000);
+static const Fixed kVeryImportantTarget     = Fixed::from_float(1.375);
+static const Fixed kSomewhatImportantTarget = Fixed::from_float(1.125);
+static const Fixed kAbsolutelyEssential     = Fixed::from_float(128.0);
+
+Fixed target_value(
+        const ScoringShip& ship, const ScoringTarget& target, bool prefers, bool forced) {
+    const Fixed friendValue = (target.local_owner == ship.owner) ? target.local_friend_strength
+                                                                  : target.local_foe_strength;
+    const Fixed foeValue = (target.local_owner == ship.owner) ? target.local_foe_strength
+                                                              : target.local_friend_strength;
+
+    Fixed thisValue = kUnimportantTarget;
+    if (target.owner == ship.owner) {
+        if (target.is_destination) {
+            if (target.escort_strength < target.escort_need) {
+                thisValue = kAbsolutelyEssential;
+            } else if (foeValue != Fixed::zero()) {
+                if (foeValue >= friendValue) {
+                    thisValue = kMostImportantTarget;
+                } else if (foeValue > (friendValue >> 1)) {
+                    thisValue = kVeryImportantTarget;
+                } else {
+                    thisValue = kUnimportantTarget;
+                }
+            } else {
+                if (ship.blitzkrieg && ship.guarding) {
+                    thisValue = kUnimportantTarget;
+                } else {
+                    if (foeValue > Fixed::zero()) {
+                        thisValue = kSomewhatImportantTarget;
+                    } else {
+                        thisValue = kUnimportantTarget;
+                    }
+                }
+            }
+            if (ship.order_flags & kSoftTargetIsBase) {
+                thisValue <<= 3;
+            }
+            if (ship.order_flags & kHardTargetIsNotBase) {
+                thisValue = Fixed::zero();
+            }
+        } else {
+            if (target.escort_class > ship.escort_class) {
+                if (foeValue > friendValue) {
+                    thisValue = kMostImportantTarget;
+                } else {
+                    if (target.escort_strength < target.escort_need) {
+                        thisValue = kMostImportantTarget;
+                    } else {
+                        thisValue = kUnimportantTarget;
+                    }
+                }
+            } else {
+                thisValue = kUnimportantTarget;
+            }
+            if (ship.order_flags & kSoftTargetIsNotBase) {
+                thisValue <<= 3;
+            }
+            if (ship.order_flags & kHardTargetIsBase) {
+                thisValue = Fixed::zero();
+            }
+        }
+        if (ship.order_flags & kSoftTargetIsFriend) {
+            thisValue <<= 3;
+        }
+        if (ship.order_flags & kHardTargetIsFoe) {
+            thisValue = Fixed::zero();
+        }
+    } else if (target.owner >= 0) {
+        if (ship.free) {
+            if (target.is_destination) {
+                if (foeValue < friendValue) {
+                    thisValue = kMostImportantTarget;
+                } else {
+                    thisValue = kSomewhatImportantTarget;
+                }
+                if (ship.blitzkrieg) {
+                    thisValue <<= 2;
+                }
+                if (ship.order_flags & kSoftTargetIsBase) {
+                    thisValue <<= 3;
+                }
+
+                if (ship.order_flags & kHardTargetIsNotBase) {
+                    thisValue = Fixed::zero();
+                }
+            } else {
+                if (friendValue != Fixed::zero()) {
+                    if (friendValue < foeValue) {
+                        thisValue = kSomewhatImportantTarget;
+                    } else {
+                        thisValue = kUnimportantTarget;
+                    }
+                } else {
+                    thisValue = kLeastImportantTarget;
+                }
+                if (ship.order_flags & kSoftTargetIsNotBase) {
+                    thisValue <<= 1;
+                }
+
+                if (ship.order_flags & kHardTargetIsBase) {
+                    thisValue = Fixed::zero();
+                }
+            }
+        }
+        if (ship.order_flags & kSoftTargetIsFoe) {
+            thisValue <<= 3;
+        }
+        if (ship.order_flags & kHardTargetIsFriend) {
+            thisValue = Fixed::zero();
+        }
+    } else {
+        if (target.is_destination) {
+            thisValue = kVeryImportantTarget;
+            if (ship.blitzkrieg) {
+                thisValue <<= 2;
+            }
+            if (ship.order_flags & kSoftTargetIsBase) {
+                thisValue <<= 3;
+            }
+            if (ship.order_flags & kHardTargetIsNotBase) {
+                thisValue = Fixed::zero();
+            }
+        } else {
+            if (ship.order_flags & kSoftTargetIsNotBase) {
+                thisValue <<= 3;
+            }
+            if (ship.order_flags & kHardTargetIsBase) {
+                thisValue = Fixed::zero();
+            }
+        }
+        if (ship.order_flags & kSoftTargetIsFoe) {
+            thisValue <<= 3;
+        }
+        if (ship.order_flags & kHardTargetIsFriend) {
+            thisValue = Fixed::zero();
+        }
+    }
+
+    int32_t dh = ABS(target.h - ship.h);
+    int32_t dv = ABS(target.v - ship.v);
+    if ((dh < kMaximumRelevantDistance) && (dv < kMaximumRelevantDistance)) {
+        if (ship.order_flags & kSoftTargetIsLocal) {
+            thisValue <<= 3;
+        }
+        if (ship.order_flags & kHardTargetIsRemote) {
+            thisValue = Fixed::zero();
+        }
+    } else {
+        if (ship.order_flags & kSoftTargetIsRemote) {
+            thisValue <<= 3;
+        }
+        if (ship.order_flags & kHardTargetIsLocal) {
+            thisValue = Fixed::zero();
+        }
+    }
+
+    if (ship.order_flags & kSoftTargetMatchesTags) {
+        if (prefers) {
+            thisValue <<= 3;
+        }
+    }
+    if (ship.order_flags & kHardTargetMatchesTags) {
+        if (!forced) {
+            thisValue = Fixed::zero();
+        }
+    }
+    return thisValue;
+}
+
+void ScoringTargets::clear() {
+    _owner.clear();
+    _kind.clear();
+    _escort_class.clear();
+    _h.clear();
+    _v.clear();
+    _local_owner.clear();
+    _local_friend_strength.clear();
+    _local_foe_strength.clear();
+}
+
+void ScoringTargets::push_back(const ScoringTarget& target) {
+    _owner.push_back(target.owner);
+    _kind.push_back(
+            (target.is_destination ? kDestination : 0) |
+            ((target.escort_strength < target.escort_need) ? kNeedsEscort : 0));
+    _escort_class.push_back(target.escort_class);
+    _h.push_back(target.h);
+    _v.push_back(target.v);
+    _local_owner.push_back(target.local_owner);
+    _local_friend_strength.push_back(target.local_friend_strength.val());
+    _local_foe_strength.push_back(target.local_foe_strength.val());
+}
+
+// target_value() only ever shifts its value left, or zeroes it. Shifts add, and a zeroed value
+// stays zero whatever is done to it next. So each target’s value is a base value, shifted by the
+// sum of the shifts that apply, unless any zeroing applies. Which shifts and zeroings apply
+// depends on the ship’s flags and on one of six cases (owner, and whether the target is a
+// destination), so they are worked out once per ship, and the per-target loops only select.
+namespace {
+
+struct Modifiers {
+    int32_t shift;
+    int32_t zero;
+};
+
+Modifiers modifiers(uint32_t flags, uint32_t soft, int32_t soft_shift, uint32_t hard) {
+    return Modifiers{(flags & soft) ? soft_shift : 0, (flags & hard) ? 1 : 0};
+}
+
+Modifiers operator+(Modifiers x, Modifiers y) {
+    return Modifiers{x.shift + y.shift, x.zero | y.zero};
+}
+
+// `a` if `cond` is 1, or `b` if it is 0, without a branch.
+inline int32_t pick(int32_t cond, int32_t a, int32_t b) { return b ^ ((a ^ b) & -cond); }
+
+}  // namespace
+
+// There are two loops, each reading few enough arrays that the compiler can check at runtime
+// that none of them overlap `values`, and vectorize the loop.
+void ScoringTargets::score(
+        const ScoringShip& ship, const int32_t* prefers, const int32_t* forced,
+        Fixed* values) const {
+    const int32_t  n            = size();
+    const int32_t* owner        = _owner.data();
+    const int32_t* kind         = _kind.data();
+    const int32_t* escort_class = _escort_class.data();
+    const int32_t* h            = _h.data();
+    const int32_t* v            = _v.data();
+    const int32_t* local_owner  = _local_owner.data();
+    const int32_t* local_friend = _local_friend_strength.data();
+    const int32_t* local_foe    = _local_foe_strength.data();
+
+    // Base values.
+    const int32_t unimportant = kUnimportantTarget.val();
+    const int32_t most        = kMostImportantTarget.val();
+    const int32_t least       = kLeastImportantTarget.val();
+    const int32_t very        = kVeryImportantTarget.val();
+    const int32_t somewhat    = kSomewhatImportantTarget.val();
+    const int32_t essential   = kAbsolutelyEssential.val();
+    const int32_t quiet       = (ship.blitzkrieg && ship.guarding) ? 0 : 1;
+    const int32_t free        = ship.free ? 1 : 0;
+    for (int32_t i = 0; i < n; ++i) {
+        const int32_t is_dest = (kind[i] & kDestination) != 0;
+        const int32_t needy   = (kind[i] & kNeedsEscort) != 0;
+        const int32_t mine    = local_owner[i] == ship.owner;
+        const int32_t friends = pick(mine, local_friend[i], local_foe[i]);
+        const int32_t foes    = pick(mine, local_foe[i], local_friend[i]);
+
+        const int32_t contested =
+                pick(foes >= friends, most, pick(foes > (friends >> 1), very, unimportant));
+        const int32_t calm            = pick(quiet & (foes > 0), somewhat, unimportant);
+        const int32_t same_dest_value = pick(needy, essential, pick(foes != 0, contested, calm));
+        const int32_t same_other_value =
+                pick((escort_class[i] > ship.escort_class) & ((foes > friends) | needy), most,
+                     unimportant);
+        const int32_t foe_dest_value =
+                pick(free, pick(foes < friends, most, somewhat), unimportant);
+        const int32_t foe_other_value =
+                pick(free, pick(friends != 0, pick(friends < foes, somewhat, unimportant), least),
+                     unimportant);
+        const int32_t none_value = pick(is_dest, very, unimportant);
+
+        const int32_t same  = owner[i] == ship.owner;
+        const int32_t owned = owner[i] >= 0;
+        values[i]           = Fixed::from_val(
+                pick(same, pick(is_dest, same_dest_value, same_other_value),
+                     pick(owned, pick(is_dest, foe_dest_value, foe_other_value), none_value)));
+    }
+
+    // Shifts and zeroings.
+    const uint32_t  f          = ship.order_flags;
+    const Modifiers base       = modifiers(f, kSoftTargetIsBase, 3, kHardTargetIsNotBase);
+    const Modifiers no_base    = modifiers(f, kSoftTargetIsNotBase, 3, kHardTargetIsBase);
+    const Modifiers as_friend  = modifiers(f, kSoftTargetIsFriend, 3, kHardTargetIsFoe);
+    const Modifiers as_foe     = modifiers(f, kSoftTargetIsFoe, 3, kHardTargetIsFriend);
+    const Modifiers blitz      = {ship.blitzkrieg ? 2 : 0, 0};
+    const Modifiers nothing    = {0, 0};
+    const Modifiers same_dest  = base + as_friend;
+    const Modifiers same_other = no_base + as_friend;
+    const Modifiers foe_dest   = (ship.free ? (blitz + base) : nothing) + as_foe;
+    const Modifiers foe_other =
+            (ship.free ? modifiers(f, kSoftTargetIsNotBase, 1, kHardTargetIsBase) : nothing) +
+            as_foe;
+    const Modifiers none_dest    = blitz + base + as_foe;
+    const Modifiers none_other   = no_base + as_foe;
+    const Modifiers local        = modifiers(f, kSoftTargetIsLocal, 3, kHardTargetIsRemote);
+    const Modifiers remote       = modifiers(f, kSoftTargetIsRemote, 3, kHardTargetIsLocal);
+    const int32_t   prefer_shift = (f & kSoftTargetMatchesTags) ? 3 : 0;
+    const int32_t   force_zero   = (f & kHardTargetMatchesTags) ? 1 : 0;
+    for (int32_t i = 0; i < n; ++i) {
+        const int32_t is_dest = (kind[i] & kDestination) != 0;
+        const int32_t same    = owner[i] == ship.owner;
+        const int32_t owned   = owner[i] >= 0;
+        const int32_t shift   = pick(
+                same, pick(is_dest, same_dest.shift, same_other.shift),
+                pick(owned, pick(is_dest, foe_dest.shift, foe_other.shift),
+                     pick(is_dest, none_dest.shift, none_other.shift)));
+        const int32_t zero = pick(
+                same, pick(is_dest, same_dest.zero, same_other.zero),
+                pick(owned, pick(is_dest, foe_dest.zero, foe_other.zero),
+                     pick(is_dest, none_dest.zero, none_other.zero)));
+
+        int32_t dh = h[i] - ship.h;
+        int32_t dv = v[i] - ship.v;
+        dh         = pick(dh < 0, -dh, dh);
+        dv         = pick(dv < 0, -dv, dv);
+        const int32_t is_local =
+                (dh < kMaximumRelevantDistance) & (dv < kMaximumRelevantDistance);
+
+        const int32_t total_shift = shift + pick(is_local, local.shift, remote.shift) +
+                                    pick(prefers[i] != 0, prefer_shift, 0);
+        const int32_t total_zero = zero | pick(is_local, local.zero, remote.zero) |
+                                   pick(forced[i] != 0, 0, force_zero);
+        values[i] = Fixed::from_val(pick(total_zero, 0, values[i].val() << total_shift));
+    }
+}
+
+}  // namespace antares
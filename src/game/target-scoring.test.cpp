@@ -0,0 +1,124 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2008-2017 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include "game/target-scoring.hpp"
+
+#include <gmock/gmock.h>
+#include <random>
+#include <vector>
+
+#include "data/base-object.hpp"
+
+using testing::ContainerEq;
+
+namespace antares {
+namespace {
+
+const int kShips   = 2000;
+const int kTargets = 200;
+
+const uint32_t kOrderFlags[] = {
+        kSoftTargetIsBase,      kHardTargetIsBase,      kSoftTargetIsNotBase, kHardTargetIsNotBase,
+        kSoftTargetIsLocal,     kHardTargetIsLocal,     kSoftTargetIsRemote,  kHardTargetIsRemote,
+        kSoftTargetIsFriend,    kHardTargetIsFriend,    kSoftTargetIsFoe,     kHardTargetIsFoe,
+        kSoftTargetMatchesTags, kHardTargetMatchesTags,
+};
+
+class TargetScoringTest : public testing::Test {
+  protected:
+    // Owners are drawn from a small set, so that ships and targets often share them.
+    int32_t owner() { return static_cast<int32_t>(_random() % 4) - 1; }
+
+    // Strengths are often zero, and often equal, since target_value() treats those specially.
+    Fixed strength() {
+        switch (_random() % 4) {
+            case 0: return Fixed::zero();
+            case 1: return Fixed::from_long(1);
+            default: return Fixed::from_val(_random() % 4096);
+        }
+    }
+
+    // Coordinates are spread so that both local and remote targets are common.
+    int32_t coordinate() { return 0x3ffe0000 + static_cast<int32_t>(_random() % 0x40000); }
+
+    bool coin() { return _random() % 2; }
+
+    ScoringShip ship() {
+        ScoringShip result;
+        result.owner       = owner();
+        result.order_flags = 0;
+        for (uint32_t flag : kOrderFlags) {
+            if ((_random() % 4) == 0) {
+                result.order_flags |= flag;
+            }
+        }
+        result.escort_class = _random() % 4;
+        result.guarding     = coin();
+        result.free         = result.guarding || coin();
+        result.blitzkrieg   = coin();
+        result.h            = coordinate();
+        result.v            = coordinate();
+        return result;
+    }
+
+    ScoringTarget target() {
+        ScoringTarget result;
+        result.owner                 = owner();
+        result.is_destination        = coin();
+        result.escort_class          = _random() % 4;
+        result.escort_strength       = strength();
+        result.escort_need           = strength();
+        result.h                     = coordinate();
+        result.v                     = coordinate();
+        result.local_owner           = coin() ? result.owner : owner();
+        result.local_friend_strength = strength();
+        result.local_foe_strength    = strength();
+        return result;
+    }
+
+    std::mt19937 _random{0};
+};
+
+// ScoringTargets::score() must give exactly the values of target_value(), which is the scoring
+// that computer admirals have always used, for every combination of flags.
+TEST_F(TargetScoringTest, BatchMatchesScalar) {
+    std::vector<ScoringTarget> targets;
+    ScoringTargets             batch;
+    for (int i = 0; i < kTargets; ++i) {
+        targets.push_back(target());
+        batch.push_back(targets.back());
+    }
+
+    for (int i = 0; i < kShips; ++i) {
+        ScoringShip          s = ship();
+        std::vector<int32_t> prefers, forced;
+        std::vector<Fixed>   expected;
+        for (const ScoringTarget& t : targets) {
+            prefers.push_back(coin());
+            forced.push_back(coin());
+            expected.push_back(target_value(s, t, prefers.back(), forced.back()));
+        }
+
+        std::vector<Fixed> actual(targets.size());
+        batch.score(s, prefers.data(), forced.data(), actual.data());
+        EXPECT_THAT(actual, ContainerEq(expected));
+    }
+}
+
+}  // namespace
+}  // namespace antares
@@ -26,9 +26,11 @@
 #include "config/file-prefs-driver.hpp"
 #include "config/ledger.hpp"
 #include "config/preferences.hpp"
+#include "drawing/pix-table.hpp"
 #include "game/sys.hpp"
 #include "glfw/video-driver.hpp"
 #include "lang/exception.hpp"
+#include "sound/fx.hpp"
 #include "sound/openal-driver.hpp"
 #include "ui/flows/master.hpp"
 
@@ -60,7 +62,12 @@ void usage(pn::output_view out, pn::string_view progname, int retcode) {
             "                        (default: {2})\n"
             "    -f, --factory       set path to factory scenario\n"
             "                        (default: {3})\n"
-            "    -h, --help          display this help screen\n",
+            "    -h, --help          display this help screen\n"
+            "        --frame-stats   print frame times and CPU usage on exit\n"
+            "        --no-vsync      show each frame without waiting for the display's refresh\n"
+            "        --shader-tinting\n"
+            "                        tint sprites when drawing them, not when loading them\n"
+            "        --voice-mixer   mix sounds with virtual voices\n",
             progname, default_application_path(), default_config_path(),
             default_factory_scenario_path());
     exit(retcode);
@@ -93,8 +100,11 @@ void main(int argc, char* const* argv) {
         }
     };
 
+    bool no_vsync    = false;
+    bool frame_stats = false;
     callbacks.long_option =
-            [&callbacks](pn::string_view opt, const args::callbacks::get_value_f& get_value) {
+            [&callbacks, &no_vsync, &frame_stats](
+                    pn::string_view opt, const args::callbacks::get_value_f& get_value) {
                 if (opt == "app-data") {
                     return callbacks.short_option(pn::rune{'a'}, get_value);
                 } else if (opt == "config") {
@@ -103,6 +113,18 @@ void main(int argc, char* const* argv) {
                     return callbacks.short_option(pn::rune{'f'}, get_value);
                 } else if (opt == "help") {
                     return callbacks.short_option(pn::rune{'h'}, get_value);
+                } else if (opt == "frame-stats") {
+                    frame_stats = true;
+                    return true;
+                } else if (opt == "shader-tinting") {
+                    NatePixTable::set_tinting(NatePixTable::Tinting::SHADER);
+                    return true;
+                } else if (opt == "voice-mixer") {
+                    SoundFX::set_mixing(SoundFX::Mixing::VOICES);
+                    return true;
+                } else if (opt == "no-vsync") {
+                    no_vsync = true;
+                    return true;
                 } else {
                     return false;
                 }
@@ -128,6 +150,8 @@ void main(int argc, char* const* argv) {
     DirectoryLedger   ledger;
     OpenAlSoundDriver sound;
     GLFWVideoDriver   video;
+    video.set_no_vsync(no_vsync);
+    video.set_frame_stats(frame_stats);
     video.loop(new Master(scenario, time(NULL)));
 }
 
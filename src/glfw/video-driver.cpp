@@ -24,12 +24,9 @@
 #include <pn/output>
 #include <sfz/sfz.hpp>
 
-#ifdef _MSC_VER
+#include <algorithm>
 #include <chrono>
-#include <thread>
-#else
-#include <unistd.h>
-#endif
+#include <ctime>
 
 #include "config/preferences.hpp"
 
@@ -38,6 +35,41 @@ using sfz::range;
 namespace antares {
 
 static const ticks kDoubleClickInterval = ticks(30);
+static const usecs kIdleRedraw          = usecs(100000);
+
+namespace {
+
+// Times each frame, from the start of drawing until the buffers are swapped, and compares the
+// CPU time used with the wall time elapsed.
+class FrameStats {
+  public:
+    FrameStats() : _start(std::chrono::steady_clock::now()), _cpu_start(std::clock()) {}
+
+    void frame(std::chrono::steady_clock::duration d) {
+        ++_frames;
+        _total += d;
+        _max = std::max(_max, d);
+    }
+
+    void print(pn::output_view out) const {
+        typedef std::chrono::duration<double, std::milli> ms;
+        double elapsed = ms(std::chrono::steady_clock::now() - _start).count();
+        double cpu     = 1000.0 * (std::clock() - _cpu_start) / CLOCKS_PER_SEC;
+        out.format(
+                "frames: {0} in {1} ms\nmean frame: {2} ms\nmax frame: {3} ms\ncpu: {4}%\n",
+                _frames, elapsed, _frames ? (ms(_total).count() / _frames) : 0.0,
+                ms(_max).count(), elapsed ? (100.0 * cpu / elapsed) : 0.0);
+    }
+
+  private:
+    const std::chrono::steady_clock::time_point _start;
+    const std::clock_t                          _cpu_start;
+    int64_t                                     _frames = 0;
+    std::chrono::steady_clock::duration         _total{0};
+    std::chrono::steady_clock::duration         _max{0};
+};
+
+}  // namespace
 
 static Key glfw_key_to_usb(int key) {
     switch (key) {
@@ -422,31 +454,42 @@ void GLFWVideoDriver::window_maximize(bool maximized) {
 void GLFWVideoDriver::key_callback(GLFWwindow* w, int key, int scancode, int action, int mods) {
     GLFWVideoDriver* driver = reinterpret_cast<GLFWVideoDriver*>(glfwGetWindowUserPointer(w));
     driver->key(key, scancode, action, mods);
+    driver->_dirty = true;
 }
 
 void GLFWVideoDriver::char_callback(GLFWwindow* w, unsigned int code_point) {
     GLFWVideoDriver* driver = reinterpret_cast<GLFWVideoDriver*>(glfwGetWindowUserPointer(w));
     driver->char_(code_point);
+    driver->_dirty = true;
 }
 
 void GLFWVideoDriver::mouse_button_callback(GLFWwindow* w, int button, int action, int mods) {
     GLFWVideoDriver* driver = reinterpret_cast<GLFWVideoDriver*>(glfwGetWindowUserPointer(w));
     driver->mouse_button(button, action, mods);
+    driver->_dirty = true;
 }
 
 void GLFWVideoDriver::mouse_move_callback(GLFWwindow* w, double x, double y) {
     GLFWVideoDriver* driver = reinterpret_cast<GLFWVideoDriver*>(glfwGetWindowUserPointer(w));
     driver->mouse_move(x, y);
+    driver->_dirty = true;
 }
 
 void GLFWVideoDriver::window_size_callback(GLFWwindow* w, int width, int height) {
     GLFWVideoDriver* driver = reinterpret_cast<GLFWVideoDriver*>(glfwGetWindowUserPointer(w));
     driver->window_size(width, height);
+    driver->_dirty = true;
 }
 
 void GLFWVideoDriver::window_maximize_callback(GLFWwindow* w, int maximized) {
     GLFWVideoDriver* driver = reinterpret_cast<GLFWVideoDriver*>(glfwGetWindowUserPointer(w));
     driver->window_maximize(maximized);
+    driver->_dirty = true;
+}
+
+void GLFWVideoDriver::window_refresh_callback(GLFWwindow* w) {
+    GLFWVideoDriver* driver = reinterpret_cast<GLFWVideoDriver*>(glfwGetWindowUserPointer(w));
+    driver->_dirty          = true;
 }
 
 pn::string_view hint_opengl20() {
@@ -503,31 +546,54 @@ void GLFWVideoDriver::loop(Card* initial) {
     glfwSetMouseButtonCallback(_window, mouse_button_callback);
     glfwSetCursorPosCallback(_window, mouse_move_callback);
     glfwSetWindowSizeCallback(_window, window_size_callback);
+    glfwSetWindowRefreshCallback(_window, window_refresh_callback);
 
     /* Make the _window's context current */
     glfwMakeContextCurrent(_window);
+    if (_no_vsync) {
+        glfwSwapInterval(0);
+    }
 
     MainLoop main_loop(*this, initial);
     _loop = &main_loop;
-    main_loop.draw();
 
+    // Sleep until there's input, or the top card's timer is due, and draw only when one of those
+    // might have changed something. A few cards animate from now() alone, without a timer, so an
+    // idle screen is still redrawn every kIdleRedraw.
+    FrameStats stats;
+    wall_time  last_draw;
+    _dirty = true;
     while (!main_loop.done() && !glfwWindowShouldClose(_window)) {
-        glfwPollEvents();
-        _loop->draw();
-        glfwSwapBuffers(_window);
         wall_time at;
         if (main_loop.top()->next_timer(at) && (now() > at)) {
             main_loop.top()->fire_timer();
+            _dirty = true;
+        }
+
+        if (_dirty || (now() >= last_draw + kIdleRedraw)) {
+            auto start = std::chrono::steady_clock::now();
             main_loop.draw();
             glfwSwapBuffers(_window);
+            stats.frame(std::chrono::steady_clock::now() - start);
+            last_draw = now();
+            _dirty    = false;
+        }
+
+        wall_time wake = last_draw + kIdleRedraw;
+        if (main_loop.top()->next_timer(at)) {
+            wake = std::min(wake, at + usecs(1));  // The timer fires once now() is past `at`.
+        }
+        double timeout = std::chrono::duration<double>(wake - now()).count();
+        if (timeout > 0) {
+            glfwWaitEventsTimeout(timeout);
         } else {
-#ifdef _MSC_VER
-            std::this_thread::sleep_for(std::chrono::microseconds(10));
-#else
-            usleep(10);
-#endif
+            glfwPollEvents();
         }
     }
+
+    if (_frame_stats) {
+        stats.print(pn::err);
+    }
 }
 
 }  // namespace antares
@@ -0,0 +1,68 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2018 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include "lang/work-queue.hpp"
+
+#include <algorithm>
+
+namespace antares {
+
+WorkQueue::WorkQueue() : _stopping(false) {}
+
+WorkQueue::~WorkQueue() {
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _ready.notify_all();
+    for (std::thread& t : _threads) {
+        t.join();
+    }
+}
+
+void WorkQueue::post(std::function<void()> job) {
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _jobs.push_back(std::move(job));
+    }
+    if (_threads.empty()) {
+        int n = std::max<int>(1, std::thread::hardware_concurrency());
+        for (int i = 0; i < n; ++i) {
+            _threads.emplace_back(&WorkQueue::work, this);
+        }
+    }
+    _ready.notify_one();
+}
+
+void WorkQueue::work() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _ready.wait(lock, [this] { return _stopping || !_jobs.empty(); });
+            if (_jobs.empty()) {
+                return;  // stopping, and nothing left to do.
+            }
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+        job();
+    }
+}
+
+}  // namespace antares
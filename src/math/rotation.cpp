@@ -18,26 +18,133 @@
 
 #include "math/rotation.hpp"
 
-#include "data/resource.hpp"
-#include "game/sys.hpp"
-#include "lang/defines.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
 #include "math/macros.hpp"
 
 namespace antares {
 
-void GetRotPoint(Fixed* x, Fixed* y, int32_t rotpos) {
-    int32_t* i;
+// The angle search below looks for the first minimum of |t(i)| over one octant of the rotation
+// table, where t(i) = v[i] * a + h[i] * b. If both components of the table move in the same
+// direction across the octant, then t is monotonic for any a, b >= 0, and the minimum is next to
+// the sign change in t. The sign change depends only on the ratio of a to b, so a table indexed
+// by ratio gives a guess, which is then corrected by checking the sign of t on either side.
+namespace {
+
+const int32_t kGuesses = 1024;
+
+struct Octant {
+    int32_t begin;
+    int32_t end;        // inclusive
+    int32_t direction;  // +1 if t is non-increasing, -1 if non-decreasing, 0 if neither.
+    int64_t limit;      // if a + b exceeds this, t may overflow int32_t.
+    int32_t guess[kGuesses + 1];  // sign change in t, by a * kGuesses / (a + b).
+};
+
+}  // namespace
+
+// s(i) = direction * t(i), which is non-increasing.
+static int64_t slope(const int32_t* table, const Octant& o, int32_t i, int32_t a, int32_t b) {
+    return o.direction * ((int64_t{table[i * 2 + 1]} * a) + (int64_t{table[i * 2]} * b));
+}
+
+// First angle in the octant at which s(i) < 0, or o.end + 1 if none, starting from `guess`.
+static int32_t sign_change(
+        const int32_t* table, const Octant& o, int32_t guess, int32_t a, int32_t b) {
+    int32_t n = guess;
+    while ((n > o.begin) && (slope(table, o, n - 1, a, b) < 0)) {
+        --n;
+    }
+    while ((n <= o.end) && (slope(table, o, n, a, b) >= 0)) {
+        ++n;
+    }
+    return n;
+}
 
-    i  = sys.rot_table.data() + rotpos * 2L;
-    *x = Fixed::from_val(*i);
-    i++;
-    *y = Fixed::from_val(*i);
+static void analyze_octant(const int32_t* table, Octant* o) {
+    bool    increasing = true, decreasing = true;
+    int32_t max        = 0;
+    for (int32_t i = o->begin; i <= o->end; ++i) {
+        const int32_t* p = table + (i * 2);
+        max              = std::max({max, std::abs(p[0]), std::abs(p[1])});
+        if (i > o->begin) {
+            increasing = increasing && (p[0] >= p[-2]) && (p[1] >= p[-1]);
+            decreasing = decreasing && (p[0] <= p[-2]) && (p[1] <= p[-1]);
+        }
+    }
+    o->direction = decreasing ? +1 : (increasing ? -1 : 0);
+    o->limit     = max ? (std::numeric_limits<int32_t>::max() / max) : 0;
+
+    int32_t n = o->begin;
+    for (int32_t q = 0; q <= kGuesses; ++q) {
+        n = o->guess[q] = o->direction ? sign_change(table, *o, n, q, kGuesses - q) : o->begin;
+    }
+}
+
+static Octant make_octant(int32_t begin, int32_t end) {
+    Octant o = {begin, end, 0, 0, {}};
+    analyze_octant(rot_table, &o);
+    return o;
+}
+
+static const Octant& octant(int32_t begin) {
+    static const Octant octants[2] = {make_octant(ROT_0, ROT_45), make_octant(ROT_45, ROT_90)};
+    return octants[begin == ROT_45];
+}
+
+// The original search, which is still needed when t isn't monotonic or might overflow.
+static int32_t walk_octant(const Octant& o, int32_t a, int32_t b) {
+    const int32_t* h          = rot_table + o.begin * 2;
+    const int32_t* v          = h + 1;
+    int32_t        whichAngle = o.begin;
+    int32_t        test = 0, best = 0, whichBest = -1;
+    do {
+        test = (*v * a) + (*h * b);  // we're adding b/c in my table 45-90 degrees, h < 0
+        if (test < 0)
+            test = -test;
+        if ((whichBest < 0) || (test < best)) {
+            best      = test;
+            whichBest = whichAngle;
+        }
+        h += 2;
+        v += 2;
+        whichAngle++;
+    } while ((test == best) && (whichAngle <= o.end));
+    return whichBest;
+}
+
+// Finds the same angle as walk_octant(). With s non-increasing, |t| falls while s >= 0 and rises
+// after. The walk stops at the first rise, and answers the first angle of the last run of equal
+// values before that.
+static int32_t seek_octant(const Octant& o, int32_t a, int32_t b) {
+    const int32_t* table = rot_table;
+    int32_t        q     = (a + b) ? static_cast<int32_t>(float(a) * kGuesses / (float(a) + b)) : 0;
+    int32_t        n     = sign_change(table, o, o.guess[std::min(q, kGuesses)], a, b);
+    if (n == o.begin) {
+        return o.begin;  // |t| never falls.
+    }
+    int64_t last = slope(table, o, n - 1, a, b);  // |t| just before the sign change.
+    if ((n <= o.end) && (-slope(table, o, n, a, b) < last)) {
+        return n;  // |t| falls once more across the sign change.
+    }
+    int32_t p = n - 1;
+    while ((p > o.begin) && (slope(table, o, p - 1, a, b) <= last)) {
+        --p;
+    }
+    return p;
+}
+
+static int32_t search_octant(const Octant& o, int32_t a, int32_t b) {
+    if (o.direction && (a >= 0) && (b >= 0) && ((int64_t{a} + b) <= o.limit)) {
+        return seek_octant(o, a, b);
+    }
+    return walk_octant(o, a, b);
 }
 
 int32_t GetAngleFromVector(int32_t x, int32_t y) {
-    int32_t* h;
-    int32_t* v;
-    int32_t  a, b, test = 0, best = 0, whichBest = -1, whichAngle;
+    int32_t a, b, whichBest;
 
     a = x;
     b = y;
@@ -47,37 +154,9 @@ int32_t GetAngleFromVector(int32_t x, int32_t y) {
     if (b < 0)
         b = -b;
     if (b < a) {
-        h          = sys.rot_table.data() + ROT_45 * 2;
-        whichAngle = ROT_45;
-        v          = h + 1;
-        do {
-            test = (*v * a) + (*h * b);  // we're adding b/c in my table 45-90 degrees, h < 0
-            if (test < 0)
-                test = -test;
-            if ((whichBest < 0) || (test < best)) {
-                best      = test;
-                whichBest = whichAngle;
-            }
-            h += 2;
-            v += 2;
-            whichAngle++;
-        } while ((test == best) && (whichAngle <= ROT_90));
+        whichBest = search_octant(octant(ROT_45), a, b);
     } else {
-        h          = sys.rot_table.data() + ROT_0 * 2;
-        whichAngle = ROT_0;
-        v          = h + 1;
-        do {
-            test = (*v * a) + (*h * b);
-            if (test < 0)
-                test = -test;
-            if ((whichBest < 0) || (test < best)) {
-                best      = test;
-                whichBest = whichAngle;
-            }
-            h += 2;
-            v += 2;
-            whichAngle++;
-        } while ((test == best) && (whichAngle <= ROT_45));
+        whichBest = search_octant(octant(ROT_0), a, b);
     }
     if (x > 0) {
         if (y < 0)
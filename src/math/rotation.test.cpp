@@ -0,0 +1,172 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2008-2017 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+
+#include "math/rotation.hpp"
+
+#include <gmock/gmock.h>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "data/resource.hpp"
+
+using testing::Eq;
+
+namespace antares {
+namespace {
+
+using RotationTest = testing::Test;
+
+// rot_table is compiled in, so make sure it still agrees with the data it was generated from.
+TEST_F(RotationTest, MatchesResource) {
+    std::vector<int32_t> resource = Resource::rotation_table();
+    ASSERT_THAT(resource.size(), Eq(size_t{ROT_TABLE_SIZE}));
+    for (int i = 0; i < ROT_TABLE_SIZE; ++i) {
+        EXPECT_THAT(rot_table[i], Eq(resource[i])) << "i = " << i;
+    }
+}
+
+// The original GetAngleFromVector(), which walked the table linearly until the error stopped
+// improving. The current one must give the same result for every input.
+int32_t ReferenceAngleFromVector(int32_t x, int32_t y) {
+    const int32_t* h;
+    const int32_t* v;
+    int32_t        a, b, test = 0, best = 0, whichBest = -1, whichAngle;
+
+    a = x;
+    b = y;
+
+    if (a < 0)
+        a = -a;
+    if (b < 0)
+        b = -b;
+    if (b < a) {
+        h          = rot_table + ROT_45 * 2;
+        whichAngle = ROT_45;
+        v          = h + 1;
+        do {
+            test = (*v * a) + (*h * b);  // we're adding b/c in my table 45-90 degrees, h < 0
+            if (test < 0)
+                test = -test;
+            if ((whichBest < 0) || (test < best)) {
+                best      = test;
+                whichBest = whichAngle;
+            }
+            h += 2;
+            v += 2;
+            whichAngle++;
+        } while ((test == best) && (whichAngle <= ROT_90));
+    } else {
+        h          = rot_table + ROT_0 * 2;
+        whichAngle = ROT_0;
+        v          = h + 1;
+        do {
+            test = (*v * a) + (*h * b);
+            if (test < 0)
+                test = -test;
+            if ((whichBest < 0) || (test < best)) {
+                best      = test;
+                whichBest = whichAngle;
+            }
+            h += 2;
+            v += 2;
+            whichAngle++;
+        } while ((test == best) && (whichAngle <= ROT_45));
+    }
+    if (x > 0) {
+        if (y < 0)
+            whichBest = whichBest + ROT_180;
+        else
+            whichBest = ROT_POS - whichBest;
+    } else if (y < 0)
+        whichBest = ROT_180 - whichBest;
+    if (whichBest == ROT_POS)
+        whichBest = ROT_0;
+    return (whichBest);
+}
+
+// Every vector with both components in [-1024, 1024]. This covers every ratio that the angle
+// search can distinguish at small magnitudes, including all the ties.
+TEST_F(RotationTest, ExhaustiveSmall) {
+    for (int32_t y = -1024; y <= 1024; ++y) {
+        for (int32_t x = -1024; x <= 1024; ++x) {
+            ASSERT_THAT(GetAngleFromVector(x, y), Eq(ReferenceAngleFromVector(x, y)))
+                    << "x = " << x << ", y = " << y;
+        }
+    }
+}
+
+// Random vectors at every magnitude, up to those large enough that the original search
+// overflows. The same seed is used every time, so failures are reproducible.
+TEST_F(RotationTest, Fuzz) {
+    std::mt19937 rand(0x414e5452);
+    for (int i = 0; i < 10000000; ++i) {
+        int32_t x = static_cast<int32_t>(rand()) >> (rand() % 32);
+        int32_t y = static_cast<int32_t>(rand()) >> (rand() % 32);
+        if ((x == std::numeric_limits<int32_t>::min()) ||
+            (y == std::numeric_limits<int32_t>::min())) {
+            continue;  // see Extremes.
+        }
+        ASSERT_THAT(GetAngleFromVector(x, y), Eq(ReferenceAngleFromVector(x, y)))
+                << "x = " << x << ", y = " << y;
+    }
+}
+
+// Excludes INT32_MIN, which the original can't negate without undefined behavior.
+TEST_F(RotationTest, Extremes) {
+    const int32_t max      = std::numeric_limits<int32_t>::max();
+    const int32_t values[] = {0, 1, -1, 2, -2, max, -max, max - 1, 1 - max};
+    for (int32_t x : values) {
+        for (int32_t y : values) {
+            EXPECT_THAT(GetAngleFromVector(x, y), Eq(ReferenceAngleFromVector(x, y)))
+                    << "x = " << x << ", y = " << y;
+        }
+    }
+}
+
+// Not run by default; compares the speed of GetAngleFromVector() with the original. Run with:
+//   out/cur/rotation-test --gtest_also_run_disabled_tests --gtest_filter=*Benchmark
+TEST_F(RotationTest, DISABLED_Benchmark) {
+    std::mt19937                             rand(0x414e5452);
+    std::vector<std::pair<int32_t, int32_t>> vectors(1 << 20);
+    for (auto& v : vectors) {
+        v = {static_cast<int32_t>(rand() % 131072) - 65536,
+             static_cast<int32_t>(rand() % 131072) - 65536};
+    }
+
+    auto time = [&vectors](int32_t (*fn)(int32_t, int32_t)) {
+        int64_t sum   = 0;
+        auto    start = std::chrono::steady_clock::now();
+        for (const auto& v : vectors) {
+            sum += fn(v.first, v.second);
+        }
+        std::chrono::duration<double, std::nano> ns = std::chrono::steady_clock::now() - start;
+        return std::make_pair(ns.count() / vectors.size(), sum);
+    };
+    auto reference = time(ReferenceAngleFromVector);
+    auto current   = time(GetAngleFromVector);
+    EXPECT_THAT(current.second, Eq(reference.second));
+    printf("reference: %.1f ns/call\n", reference.first);
+    printf("current:   %.1f ns/call (%.1fx)\n", current.first, reference.first / current.first);
+}
+
+}  // namespace
+}  // namespace antares
@@ -0,0 +1,153 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2008-2017 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+
+#include "math/special.hpp"
+
+#include <gmock/gmock.h>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+using testing::Eq;
+
+namespace antares {
+namespace {
+
+using SpecialTest = testing::Test;
+
+// The original lsqrt(), by Ron Hunsinger (mac.programmer, May 1994). The current one must give
+// the same result for every input.
+uint32_t reference_lsqrt(uint32_t n) {
+    const uint32_t lsqrt_max4pow = 1UL << 30;
+
+    uint32_t residue;  // n - x^2
+    uint32_t root;     // x + 1/4
+    uint32_t half;     // 1/2
+
+    residue = n;  // n - (x = 0)^2, with suitable alignment
+
+    // if the correct answer fits in two bits, pull it out of a magic hat
+    if (residue <= 12)
+        return (0x03FFEA94 >> (residue *= 2)) & 3;
+    root = lsqrt_max4pow;  // x + 1/4, shifted all the way left
+
+    // Unwind iterations corresponding to leading zero bits
+    while (root > residue)
+        root >>= 2;
+
+    // Unwind the iteration corresponding to the first one bit
+    residue -= root;   // Decrease (n-x^2) by (0+1/4)
+    half = root >> 2;  // 1/4, with binary point shifted right 2
+    root += half;      // x=1.  (root is now (x=1)+1/4.)
+    half += half;      // 1/2, properly aligned
+
+    // Normal loop (there is at least one iteration remaining)
+    do {
+        if (root <= residue) {  // Whenever we can,
+            residue -= root;    // decrease (n-x^2) by (x+1/4)
+            root += half;       // increase x by 1/2
+        }
+        half >>= 2;    // Shift binary point 2 places right
+        root -= half;  // x{+1/2}+1/4 - 1/8 == x{+1/2}+1/8
+        root >>= 1;    // 2x{+1}+1/4, shifted right 2 places
+    } while (half);    // When 1/2 == 0, bin. point is at far right
+
+    if (root < residue)
+        ++root;  // round up if (x+1/2)^2 < n
+
+    return root;  // Guaranteed to be correctly rounded
+}
+
+// lsqrt(n) only changes value where n crosses x^2 + x + 1 for some x, so checking every
+// neighborhood of x^2 and x^2 + x is as good as checking all 2^32 inputs.
+TEST_F(SpecialTest, LsqrtBoundaries) {
+    for (uint64_t x = 0; x <= 65536; ++x) {
+        for (uint64_t base : {x * x, (x * x) + x}) {
+            for (uint64_t n = (base < 2) ? 0 : (base - 2); n <= base + 2; ++n) {
+                if (n <= std::numeric_limits<uint32_t>::max()) {
+                    ASSERT_THAT(lsqrt(uint32_t(n)), Eq(reference_lsqrt(uint32_t(n))))
+                            << "n = " << n;
+                }
+            }
+        }
+    }
+}
+
+TEST_F(SpecialTest, LsqrtExhaustiveSmall) {
+    for (uint32_t n = 0; n < (1 << 20); ++n) {
+        ASSERT_THAT(lsqrt(n), Eq(reference_lsqrt(n))) << "n = " << n;
+    }
+}
+
+TEST_F(SpecialTest, LsqrtFuzz) {
+    std::mt19937 rand(0x414e5452);
+    for (int i = 0; i < 10000000; ++i) {
+        uint32_t n = rand() >> (rand() % 32);
+        ASSERT_THAT(lsqrt(n), Eq(reference_lsqrt(n))) << "n = " << n;
+    }
+}
+
+TEST_F(SpecialTest, Wsqrt) {
+    EXPECT_THAT(wsqrt(0), Eq(0u));
+    EXPECT_THAT(wsqrt(0xffffffffull), Eq(65536u));
+    EXPECT_THAT(wsqrt(0x100000000ull), Eq(65536u));
+    EXPECT_THAT(wsqrt(0xffffffffffffffffull), Eq(0x100000000ull));
+
+    std::mt19937_64 rand(0x414e5452);
+    for (int i = 0; i < 1000000; ++i) {
+        uint64_t n          = rand() >> (rand() % 64);
+        int      correction = 0;
+        uint64_t m          = n;
+        while ((m & 0xffffffff00000000ull) != 0) {
+            correction += 4;
+            m >>= 8;
+        }
+        ASSERT_THAT(wsqrt(n), Eq(uint64_t{reference_lsqrt(m)} << correction)) << "n = " << n;
+    }
+}
+
+// Not run by default; compares the speed of lsqrt() with the original. Run with:
+//   out/cur/special-test --gtest_also_run_disabled_tests --gtest_filter=*Benchmark
+TEST_F(SpecialTest, DISABLED_Benchmark) {
+    std::mt19937          rand(0x414e5452);
+    std::vector<uint32_t> inputs(1 << 20);
+    for (auto& n : inputs) {
+        n = rand() >> (rand() % 32);
+    }
+
+    auto time = [&inputs](uint32_t (*fn)(uint32_t)) {
+        uint64_t sum   = 0;
+        auto     start = std::chrono::steady_clock::now();
+        for (uint32_t n : inputs) {
+            sum += fn(n);
+        }
+        std::chrono::duration<double, std::nano> ns = std::chrono::steady_clock::now() - start;
+        return std::make_pair(ns.count() / inputs.size(), sum);
+    };
+    auto reference = time(reference_lsqrt);
+    auto current   = time(static_cast<uint32_t (*)(uint32_t)>(lsqrt));
+    EXPECT_THAT(current.second, Eq(reference.second));
+    printf("reference: %.1f ns/call\n", reference.first);
+    printf("current:   %.1f ns/call (%.1fx)\n", current.first, reference.first / current.first);
+}
+
+}  // namespace
+}  // namespace antares
@@ -18,10 +18,12 @@
 
 #include "sound/fx.hpp"
 
+#include <chrono>
 #include <pn/output>
 
 #include "config/preferences.hpp"
 #include "data/base-object.hpp"
+#include "data/resource.hpp"
 #include "game/globals.hpp"
 #include "game/motion.hpp"
 #include "game/space-object.hpp"
@@ -37,6 +39,10 @@ namespace antares {
 
 static const int32_t kMaxChannelNum = 3;
 
+// Used by Mixing::VOICES.
+static const int kMaxVoiceNum         = 32;
+static const int kMaxRealizedVoiceNum = 8;
+
 // sound 0-13 always used -- loaded at start; 14+ may be swapped around
 static const int kMinVolatileSound = 14;
 
@@ -85,24 +91,46 @@ enum {
 };
 
 struct SoundFX::smartSoundChannel {
-    pn::string                    whichSound;
+    int                           whichSound;  // Interned ID, or -1 if none.
     wall_time                     reserved_until;
     int16_t                       soundVolume;
     uint8_t                       soundPriority;
     std::unique_ptr<SoundChannel> channelPtr;
+    SoundFX::Voice*               voice;  // Realized on this channel, with Mixing::VOICES.
 };
 
-struct SoundFX::smartSoundHandle {
-    pn::string             id;
-    std::unique_ptr<Sound> soundHandle;
+struct SoundFX::Voice {
+    int       sound;  // Interned ID, or -1 if the voice is free.
+    uint8_t   amplitude;
+    uint8_t   priority;
+    wall_time reserved_until;
+    int64_t   started;  // Order in which voices were started, for breaking ties.
+    int       channel;  // Index into `channels`, or -1 if the voice is virtual.
 };
 
+static ANTARES_GLOBAL SoundFX::Mixing sound_mixing = SoundFX::Mixing::CHANNELS;
+
+void SoundFX::set_mixing(Mixing mixing) { sound_mixing = mixing; }
+
+SoundFX::Mixing SoundFX::mixing() { return sound_mixing; }
+
+// Returns the number that `id` is interned as, interning it if this is the first time it's seen.
+// Numbers are never reused, so a channel's `whichSound` identifies the same sound after reset().
+int SoundFX::intern(pn::string_view id) {
+    auto it = sound_ids.find(id);
+    if (it != sound_ids.end()) {
+        return it->second;
+    }
+    sound_names.push_back(id.copy());
+    sounds.emplace_back();
+    return sound_ids[sound_names.back()] = sounds.size() - 1;
+}
+
 // see if there's a channel with the same sound at same or lower volume
-bool SoundFX::same_sound_channel(
-        int& channel, pn::string_view id, uint8_t amplitude, uint8_t priority) {
+bool SoundFX::same_sound_channel(int& channel, int sound, uint8_t amplitude, uint8_t priority) {
     if (priority > kVeryLowPrioritySound) {
         for (int i = 0; i < kMaxChannelNum; ++i) {
-            if ((channels[i].whichSound == id) && (channels[i].soundVolume <= amplitude)) {
+            if ((channels[i].whichSound == sound) && (channels[i].soundVolume <= amplitude)) {
                 channel = i;
                 return true;
             }
@@ -149,89 +177,248 @@ bool SoundFX::oldest_available_channel(int& channel) {
 }
 
 bool SoundFX::best_channel(
-        int& channel, pn::string_view sound_id, uint8_t amplitude, usecs persistence,
-        uint8_t priority) {
-    return same_sound_channel(channel, sound_id, amplitude, priority) ||
+        int& channel, int sound, uint8_t amplitude, usecs persistence, uint8_t priority) {
+    return same_sound_channel(channel, sound, amplitude, priority) ||
            quieter_channel(channel, amplitude) || lower_priority_channel(channel, priority) ||
            oldest_available_channel(channel);
 }
 
-void SoundFX::play(pn::string_view id, uint8_t amplitude, usecs persistence, uint8_t priority) {
-    int32_t whichChannel = -1;
-    // TODO(sfiera): don't play sound at all if the game is muted.
-    if (amplitude > 0) {
-        if (!best_channel(whichChannel, id, amplitude, persistence, priority)) {
-            return;
+// True if `x` should be heard over `y`.
+bool SoundFX::outranks(const Voice& x, const Voice& y) {
+    if (x.priority != y.priority) {
+        return x.priority > y.priority;
+    } else if (x.amplitude != y.amplitude) {
+        return x.amplitude > y.amplitude;
+    }
+    return x.started > y.started;
+}
+
+// Finds a voice to play `sound` on: one already playing it no louder, so that it isn't doubled
+// up; otherwise a free voice; otherwise the lowest-ranked voice, if the new sound outranks it.
+SoundFX::Voice* SoundFX::voice_for(int sound, uint8_t amplitude, uint8_t priority) {
+    Voice* unused = nullptr;
+    Voice* lowest = nullptr;
+    for (Voice& v : voices) {
+        if (v.sound < 0) {
+            unused = unused ? unused : &v;
+        } else if (
+                (priority > kVeryLowPrioritySound) && (v.sound == sound) &&
+                (v.amplitude <= amplitude)) {
+            return &v;
+        } else if (!lowest || outranks(*lowest, v)) {
+            lowest = &v;
         }
+    }
+    if (unused) {
+        return unused;
+    }
+    Voice candidate;
+    candidate.amplitude = amplitude;
+    candidate.priority  = priority;
+    candidate.started   = next_voice;
+    if (outranks(candidate, *lowest)) {
+        release(*lowest);
+        return lowest;
+    }
+    return nullptr;
+}
 
-        int whichSound = 0;
-        for (; whichSound < sounds.size(); ++whichSound) {
-            if (sounds[whichSound].id == id) {
-                break;
+// Plays `voice` on a channel, if it ranks among the voices that are heard. It takes a channel
+// with no voice, or else the channel of the lowest-ranked voice, which becomes virtual.
+void SoundFX::realize(Voice& voice) {
+    int channel = voice.channel;
+    for (int i = 0; (channel < 0) && (i < channels.size()); ++i) {
+        if (!channels[i].voice) {
+            channel = i;
+        }
+    }
+    if (channel < 0) {
+        Voice* lowest = nullptr;
+        for (smartSoundChannel& c : channels) {
+            if (!lowest || outranks(*lowest, *c.voice)) {
+                lowest = c.voice;
             }
         }
-        if (whichSound == sounds.size()) {
+        if (!outranks(voice, *lowest)) {
             return;
         }
+        channel         = lowest->channel;
+        lowest->channel = -1;
+    }
+
+    voice.channel           = channel;
+    channels[channel].voice = &voice;
+    channels[channel].channelPtr->activate();
+    sounds[voice.sound]->play(voice.amplitude);
+}
+
+// Frees `voice`. If it's realized, its sound plays out, but the channel can be taken.
+void SoundFX::release(Voice& voice) {
+    if (voice.channel >= 0) {
+        channels[voice.channel].voice = nullptr;
+    }
+    voice.sound   = -1;
+    voice.channel = -1;
+}
+
+void SoundFX::play(pn::string_view id, uint8_t amplitude, usecs persistence, uint8_t priority) {
+    auto it = sound_ids.find(id);
+    if ((it != sound_ids.end()) && sounds[it->second]) {
+        play_sound(it->second, amplitude, persistence, priority);
+    }
+}
+
+void SoundFX::play_sound(int sound, uint8_t amplitude, usecs persistence, uint8_t priority) {
+    // TODO(sfiera): don't play sound at all if the game is muted.
+    if (amplitude == 0) {
+        return;
+    }
+
+    if (mixing() == Mixing::VOICES) {
+        wall_time t = now();
+        for (Voice& v : voices) {
+            if ((v.sound >= 0) && (v.reserved_until <= t)) {
+                release(v);
+            }
+        }
 
-        channels[whichChannel].whichSound     = id.copy();
-        channels[whichChannel].reserved_until = now() + persistence;
-        channels[whichChannel].soundPriority  = priority;
-        channels[whichChannel].soundVolume    = amplitude;
+        Voice* v = voice_for(sound, amplitude, priority);
+        if (!v) {
+            return;
+        }
+        v->sound          = sound;
+        v->amplitude      = amplitude;
+        v->priority       = priority;
+        v->reserved_until = t + persistence;
+        v->started        = next_voice++;
+        realize(*v);
+        return;
+    }
 
-        channels[whichChannel].channelPtr->activate();
-        sounds[whichSound].soundHandle->play(amplitude);
+    int32_t whichChannel = -1;
+    if (!best_channel(whichChannel, sound, amplitude, persistence, priority)) {
+        return;
     }
+
+    channels[whichChannel].whichSound     = sound;
+    channels[whichChannel].reserved_until = now() + persistence;
+    channels[whichChannel].soundPriority  = priority;
+    channels[whichChannel].soundVolume    = amplitude;
+
+    channels[whichChannel].channelPtr->activate();
+    sounds[sound]->play(amplitude);
 }
 
-SoundFX::SoundFX() {}
+SoundFX::SoundFX() : next_voice(0) {}
 SoundFX::~SoundFX() {}
 
 void SoundFX::init() {
-    channels.resize(kMaxChannelNum);
-    for (int i = 0; i < kMaxChannelNum; i++) {
-        channels[i].reserved_until = wall_time();
-        channels[i].soundPriority  = kNoSound;
-        channels[i].soundVolume    = 0;
-        channels[i].channelPtr     = sys.audio->open_channel();
-        channels[i].whichSound.clear();
+    channels.resize((mixing() == Mixing::VOICES) ? kMaxRealizedVoiceNum : kMaxChannelNum);
+    for (smartSoundChannel& c : channels) {
+        c.whichSound     = -1;
+        c.reserved_until = wall_time();
+        c.soundPriority  = kNoSound;
+        c.soundVolume    = 0;
+        c.channelPtr     = sys.audio->open_channel();
+        c.voice          = nullptr;
+    }
+    voices.resize((mixing() == Mixing::VOICES) ? kMaxVoiceNum : 0);
+    for (Voice& v : voices) {
+        v.sound   = -1;
+        v.channel = -1;
     }
 
     reset();
 }
 
 void SoundFX::shutdown() {
-    sounds.resize(0);
-    channels.resize(0);
+    for (auto& d : decoding) {
+        d.second.wait();
+    }
+    decoding.clear();
+    sounds.clear();
+    sound_ids.clear();
+    sound_names.clear();
+    channels.clear();
+    voices.clear();
 }
 
 void SoundFX::reset() {
-    sounds.resize(kMinVolatileSound);
-    for (int i = 0; i < kMinVolatileSound; ++i) {
-        if (!sounds[i].soundHandle.get()) {
-            auto id               = kFixedSounds[i];
-            sounds[i].id          = id.copy();
-            sounds[i].soundHandle = sys.audio->open_sound(id);
+    for (auto& d : decoding) {
+        d.second.wait();
+    }
+    decoding.clear();
+    num_requested = 0;
+    for (int i = kMinVolatileSound; i < sounds.size(); ++i) {
+        sounds[i].reset();
+    }
+    for (Voice& v : voices) {
+        if (v.sound >= kMinVolatileSound) {
+            release(v);
         }
     }
+    for (pn::string_view id : kFixedSounds) {
+        load(id);
+    }
 }
 
 void SoundFX::load(pn::string_view id) {
-    int whichSound = 0;
-    while ((whichSound < sounds.size()) && (sounds[whichSound].id != id)) {
-        whichSound++;
+    int sound = intern(id);
+    if (!sounds[sound]) {
+        sounds[sound] = sys.audio->open_sound(id);
     }
+}
+
+namespace {
+
+struct DecodeSound {
+    pn::string id;
+    SoundData  operator()() const { return Resource::sound(id); }
+};
+
+}  // namespace
 
-    if (whichSound == sounds.size()) {
-        sounds.emplace_back();
-        sounds.back().id          = id.copy();
-        sounds.back().soundHandle = sys.audio->open_sound(id);
+void SoundFX::request(pn::string_view id) {
+    int sound = intern(id);
+    if (sounds[sound]) {
+        return;
+    }
+    for (const auto& d : decoding) {
+        if (d.first == sound) {
+            return;
+        }
     }
+    if (!sys.audio->decodes_sounds() || !Resource::thread_safe()) {
+        load(id);
+        return;
+    }
+
+    auto task = std::make_shared<std::packaged_task<SoundData()>>(DecodeSound{id.copy()});
+    decoding.emplace_back(sound, task->get_future());
+    work.post([task] { (*task)(); });
+    ++num_requested;
+}
+
+int SoundFX::upload() {
+    if (!decoding.empty()) {
+        decoding.front().second.wait();
+    }
+    while (!decoding.empty() && (decoding.front().second.wait_for(std::chrono::seconds(0)) ==
+                                 std::future_status::ready)) {
+        int sound = decoding.front().first;
+        sounds[sound] =
+                sys.audio->open_decoded_sound(sound_names[sound], decoding.front().second.get());
+        decoding.pop_front();
+    }
+    return decoding.size();
 }
 
 void SoundFX::stop() {
-    for (int i = 0; i < kMaxChannelNum; i++) {
-        channels[i].channelPtr->quiet();
+    for (smartSoundChannel& c : channels) {
+        c.channelPtr->quiet();
+    }
+    for (Voice& v : voices) {
+        release(v);
     }
 }
 
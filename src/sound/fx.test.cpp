@@ -0,0 +1,209 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2008-2018 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include "sound/fx.hpp"
+
+#include <gmock/gmock.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "game/sys.hpp"
+#include "sound/driver.hpp"
+#include "video/text-driver.hpp"
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+using testing::Pair;
+
+namespace antares {
+namespace {
+
+// Records each sound played, with the index of the channel it played on.
+class RecordingSoundDriver : public SoundDriver {
+  public:
+    std::unique_ptr<SoundChannel> open_channel() override {
+        return std::unique_ptr<SoundChannel>(new Channel(this, _num_channels++));
+    }
+    std::unique_ptr<Sound> open_sound(pn::string_view path) override {
+        return std::unique_ptr<Sound>(new RecordingSound(this, path));
+    }
+    std::unique_ptr<Sound> open_music(pn::string_view path) override { return open_sound(path); }
+    void                   set_global_volume(uint8_t volume) override {}
+
+    std::vector<std::pair<int, std::string>> plays;
+
+  private:
+    class Channel : public SoundChannel {
+      public:
+        Channel(RecordingSoundDriver* driver, int index) : _driver(driver), _index(index) {}
+        void activate() override { _driver->_active_channel = _index; }
+        void quiet() override {}
+
+      private:
+        RecordingSoundDriver* const _driver;
+        const int                   _index;
+    };
+
+    class RecordingSound : public Sound {
+      public:
+        RecordingSound(RecordingSoundDriver* driver, pn::string_view path)
+                : _driver(driver), _path(path.data(), path.size()) {}
+        void play(uint8_t volume) override {
+            _driver->plays.emplace_back(_driver->_active_channel, _path);
+        }
+        void loop(uint8_t volume) override { play(volume); }
+
+      private:
+        RecordingSoundDriver* const _driver;
+        const std::string           _path;
+    };
+
+    int _num_channels   = 0;
+    int _active_channel = -1;
+};
+
+// A clock that only moves when the test moves it.
+class ClockVideoDriver : public TextVideoDriver {
+  public:
+    ClockVideoDriver() : TextVideoDriver({640, 480}, sfz::nullopt) {}
+    wall_time now() const override { return time; }
+
+    wall_time time;
+};
+
+class VoicesTest : public testing::Test {
+  public:
+    VoicesTest() {
+        SoundFX::set_mixing(SoundFX::Mixing::VOICES);
+        fx.init();
+        for (int i = 0; i < 40; ++i) {
+            fx.load(name(i));
+        }
+        audio.plays.clear();
+    }
+    ~VoicesTest() {
+        fx.shutdown();
+        SoundFX::set_mixing(SoundFX::Mixing::CHANNELS);
+    }
+
+    static pn::string name(int i) { return pn::format("test/{0}", i); }
+
+    void play(int i, uint8_t priority, uint8_t amplitude = 128) {
+        fx.play(name(i), amplitude, secs(10), priority);
+    }
+
+    ClockVideoDriver     video;
+    RecordingSoundDriver audio;
+    SoundFX              fx;
+};
+
+TEST_F(VoicesTest, EachVoiceTakesAFreeChannel) {
+    for (int i = 0; i < 8; ++i) {
+        play(i, 3);
+    }
+    ASSERT_EQ(audio.plays.size(), 8u);
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_THAT(audio.plays[i].second, name(i).c_str());
+        for (int j = 0; j < i; ++j) {
+            EXPECT_NE(audio.plays[i].first, audio.plays[j].first);
+        }
+    }
+}
+
+// With every channel taken by voices of equal rank, a new one takes the oldest's channel.
+TEST_F(VoicesTest, NewerVoiceTakesOldestChannel) {
+    for (int i = 0; i < 8; ++i) {
+        play(i, 3);
+    }
+    int oldest = audio.plays[0].first;
+    audio.plays.clear();
+    play(8, 3);
+    EXPECT_THAT(audio.plays, ElementsAre(Pair(oldest, "test/8")));
+}
+
+// A quieter or lower-priority voice isn't heard over the ones already playing.
+TEST_F(VoicesTest, LowerRankedVoiceIsNotHeard) {
+    for (int i = 0; i < 8; ++i) {
+        play(i, 3);
+    }
+    audio.plays.clear();
+    play(8, 2);
+    play(9, 3, 64);
+    EXPECT_THAT(audio.plays, IsEmpty());
+}
+
+// A higher-priority voice takes the channel of the lowest-ranked one: lowest priority first,
+// then quietest.
+TEST_F(VoicesTest, HigherPriorityTakesLowestRankedChannel) {
+    for (int i = 0; i < 8; ++i) {
+        play(i, (i == 5) ? 2 : 3, (i == 2) ? 64 : 128);
+    }
+    int low_priority = audio.plays[5].first;
+    int quiet        = audio.plays[2].first;
+    audio.plays.clear();
+    play(8, 4);
+    play(9, 4);
+    EXPECT_THAT(audio.plays, ElementsAre(Pair(low_priority, "test/8"), Pair(quiet, "test/9")));
+}
+
+// Once all 32 voices are taken, a new voice replaces the lowest-ranked one, if it outranks it.
+TEST_F(VoicesTest, VoiceStealing) {
+    for (int i = 0; i < 32; ++i) {
+        play(i, (i == 20) ? 2 : 3);
+    }
+    audio.plays.clear();
+
+    // Outranks nothing; dropped.
+    play(32, 1);
+    EXPECT_THAT(audio.plays, IsEmpty());
+
+    // Replaces voice 20, but is too quiet to be heard over the 8 voices on channels.
+    play(33, 3, 64);
+    EXPECT_THAT(audio.plays, IsEmpty());
+
+    // Voice 20 is gone, so there's no voice left that priority 2 outranks.
+    play(34, 2);
+    EXPECT_THAT(audio.plays, IsEmpty());
+
+    // Replaces voice 33, and is heard over the oldest voice on a channel.
+    play(35, 4);
+    EXPECT_THAT(audio.plays, ElementsAre(Pair(0, "test/35")));
+}
+
+// Playing a sound that a voice is already playing, no louder, restarts it on the same voice.
+TEST_F(VoicesTest, SameSoundReusesVoice) {
+    play(0, 3);
+    play(0, 3);
+    EXPECT_THAT(audio.plays, ElementsAre(Pair(0, "test/0"), Pair(0, "test/0")));
+}
+
+// Voices whose persistence has run out free their channels for anything.
+TEST_F(VoicesTest, ExpiredVoicesFreeChannels) {
+    for (int i = 0; i < 8; ++i) {
+        play(i, 5);
+    }
+    int first = audio.plays[0].first;
+    audio.plays.clear();
+    video.time += secs(11);
+    play(8, 1);
+    EXPECT_THAT(audio.plays, ElementsAre(Pair(first, "test/8")));
+}
+
+}  // namespace
+}  // namespace antares
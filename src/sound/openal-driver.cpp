@@ -18,10 +18,17 @@
 
 #include "sound/openal-driver.hpp"
 
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <pn/output>
+#include <thread>
+#include <vector>
 
 #include "data/audio.hpp"
 #include "data/resource.hpp"
+#include "lang/defines.hpp"
 
 using std::unique_ptr;
 
@@ -29,6 +36,17 @@ namespace antares {
 
 namespace {
 
+// Music is decoded into a ring of this many buffers, each holding this many bytes (about 0.37s
+// of 44.1 kHz stereo), which are refilled and requeued as the source finishes them.
+const int                       kStreamBuffers    = 4;
+const int                       kStreamBufferSize = 64 << 10;
+const std::chrono::milliseconds kStreamPoll(50);
+
+// OpenAL's error state belongs to the context, not the thread, so the streaming thread could
+// otherwise see, or clear, an error raised on the main thread. Every AL call is made, and its
+// error checked, with this held. Where a channel's mutex is also needed, it's taken first.
+ANTARES_GLOBAL std::mutex al_mutex;
+
 const char* al_error_to_string(int error) {
     switch (error) {
         case AL_NO_ERROR: return "AL_NO_ERROR";
@@ -56,6 +74,7 @@ class OpenAlSoundDriver::OpenAlSound : public Sound {
     OpenAlSound(const OpenAlSoundDriver& driver) : _driver(driver), _buffer(generate_buffer()) {}
 
     ~OpenAlSound() {
+        std::unique_lock<std::mutex> al(al_mutex);
         alDeleteBuffers(1, &_buffer);
         alGetError();  // discard.
     }
@@ -65,7 +84,9 @@ class OpenAlSoundDriver::OpenAlSound : public Sound {
 
     void buffer(const SoundData& s) {
         ALenum format = (s.channels == 1) ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
-        alBufferData(_buffer, format, s.data.data(), s.data.size(), s.frequency);
+
+        std::unique_lock<std::mutex> al(al_mutex);
+        alBufferData(_buffer, format, s.samples().data(), s.samples().size(), s.frequency);
         check_al_error("alBufferData");
     }
 
@@ -73,7 +94,8 @@ class OpenAlSoundDriver::OpenAlSound : public Sound {
 
   private:
     static ALuint generate_buffer() {
-        ALuint buffer;
+        std::unique_lock<std::mutex> al(al_mutex);
+        ALuint                       buffer;
         alGenBuffers(1, &buffer);
         check_al_error("alGenBuffers");
         return buffer;
@@ -83,9 +105,70 @@ class OpenAlSoundDriver::OpenAlSound : public Sound {
     ALuint                   _buffer;
 };
 
+// A song that's decoded as it plays, rather than all at once. It can only be played by one
+// channel at a time.
+class OpenAlSoundDriver::OpenAlMusic : public Sound {
+  public:
+    OpenAlMusic(const OpenAlSoundDriver& driver, std::unique_ptr<SoundStream> stream)
+            : _driver(driver),
+              _stream(std::move(stream)),
+              _pcm(kStreamBufferSize),
+              _channel(nullptr) {
+        std::unique_lock<std::mutex> al(al_mutex);
+        alGenBuffers(_buffers.size(), _buffers.data());
+        check_al_error("alGenBuffers");
+    }
+
+    ~OpenAlMusic();
+
+    virtual void play(uint8_t volume);
+    virtual void loop(uint8_t volume);
+
+    // Decodes the next part of the song into `buffer`. Returns false if there is nothing left to
+    // decode, which only happens if `loop` is false. Only the upload is made under `al_mutex`.
+    bool fill(ALuint buffer, bool loop) {
+        int  size    = 0;
+        bool rewound = false;
+        while (size < _pcm.size()) {
+            int n = _stream->read(_pcm.data() + size, _pcm.size() - size);
+            if (n > 0) {
+                size += n;
+                rewound = false;
+            } else if (loop && !rewound) {
+                _stream->rewind();
+                rewound = true;
+            } else {
+                break;
+            }
+        }
+        if (size == 0) {
+            return false;
+        }
+        ALenum format = (_stream->channels() == 1) ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+
+        std::unique_lock<std::mutex> al(al_mutex);
+        alBufferData(buffer, format, _pcm.data(), size, _stream->frequency());
+        check_al_error("alBufferData");
+        return true;
+    }
+
+    const std::array<ALuint, kStreamBuffers>& buffers() const { return _buffers; }
+
+  private:
+    friend class OpenAlChannel;
+
+    const OpenAlSoundDriver&           _driver;
+    std::unique_ptr<SoundStream>       _stream;
+    std::array<ALuint, kStreamBuffers> _buffers;
+    std::vector<uint8_t>               _pcm;
+    OpenAlChannel*                     _channel;  // The channel streaming this song, if any.
+};
+
 class OpenAlSoundDriver::OpenAlChannel : public SoundChannel {
   public:
-    OpenAlChannel(OpenAlSoundDriver& driver) : _driver(driver) {
+    OpenAlChannel(OpenAlSoundDriver& driver)
+            : _driver(driver), _music(nullptr), _streaming(false) {
+        std::unique_lock<std::mutex> al(al_mutex);
         alGenSources(1, &_source);
         check_al_error("alGenSources");
         alSourcef(_source, AL_PITCH, 1.0f);
@@ -94,6 +177,8 @@ class OpenAlSoundDriver::OpenAlChannel : public SoundChannel {
     }
 
     ~OpenAlChannel() {
+        stop_streaming();
+        std::unique_lock<std::mutex> al(al_mutex);
         alDeleteSources(1, &_source);
         alGetError();  // discard.
     }
@@ -103,6 +188,7 @@ class OpenAlSoundDriver::OpenAlChannel : public SoundChannel {
     void play(const OpenAlSound& sound, uint8_t volume) {
         quiet();
 
+        std::unique_lock<std::mutex> al(al_mutex);
         alSourcef(_source, AL_GAIN, volume / 255.0f);
         check_al_error("alSourcef");
         alSourcei(_source, AL_LOOPING, AL_FALSE);
@@ -116,6 +202,7 @@ class OpenAlSoundDriver::OpenAlChannel : public SoundChannel {
     void loop(const OpenAlSound& sound, uint8_t volume) {
         quiet();
 
+        std::unique_lock<std::mutex> al(al_mutex);
         alSourcef(_source, AL_GAIN, volume / 255.0f);
         check_al_error("alSourcef");
         alSourcei(_source, AL_LOOPING, AL_TRUE);
@@ -126,14 +213,120 @@ class OpenAlSoundDriver::OpenAlChannel : public SoundChannel {
         check_al_error("alSourcePlay");
     }
 
+    // Queues the first buffers of `music` on this channel's source, and starts a thread that
+    // refills and requeues each buffer as it finishes playing.
+    void stream(OpenAlMusic& music, uint8_t volume, bool loop) {
+        quiet();
+
+        std::unique_lock<std::mutex> al(al_mutex);
+        alSourcef(_source, AL_GAIN, volume / 255.0f);
+        check_al_error("alSourcef");
+        alSourcei(_source, AL_LOOPING, AL_FALSE);
+        check_al_error("alSourcei");
+        al.unlock();
+        for (ALuint buffer : music.buffers()) {
+            if (!music.fill(buffer, loop)) {
+                break;
+            }
+            al.lock();
+            alSourceQueueBuffers(_source, 1, &buffer);
+            check_al_error("alSourceQueueBuffers");
+            al.unlock();
+        }
+        al.lock();
+        alSourcePlay(_source);
+        check_al_error("alSourcePlay");
+        al.unlock();
+
+        _music           = &music;
+        _music->_channel = this;
+        _streaming       = true;
+        _streamer        = std::thread(&OpenAlChannel::feed, this, loop);
+    }
+
     void quiet() override {
+        stop_streaming();
+        std::unique_lock<std::mutex> al(al_mutex);
         alSourceStop(_source);
         check_al_error("alSourceStop");
     }
 
+    // Stops refilling buffers for the current song, if any, and detaches them from the source,
+    // so that they can be deleted.
+    void stop_streaming() {
+        if (!_music) {
+            return;
+        }
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _streaming = false;
+        }
+        _wake.notify_all();
+        _streamer.join();
+        std::unique_lock<std::mutex> al(al_mutex);
+        alSourceStop(_source);
+        alSourcei(_source, AL_BUFFER, 0);
+        check_al_error("alSourcei");
+        _music->_channel = nullptr;
+        _music           = nullptr;
+    }
+
   private:
-    OpenAlSoundDriver& _driver;
-    ALuint             _source;
+    // Runs on `_streamer`. Errors can't be thrown to anyone from here, so a song that fails to
+    // decode or queue goes silent instead.
+    void feed(bool loop) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        bool                         more = true;
+        while (_streaming) {
+            _wake.wait_for(lock, kStreamPoll);
+            if (!_streaming) {
+                break;
+            }
+            try {
+                std::unique_lock<std::mutex> al(al_mutex);
+                ALint                        processed;
+                alGetSourcei(_source, AL_BUFFERS_PROCESSED, &processed);
+                check_al_error("alGetSourcei");
+                for (int i = 0; i < processed; ++i) {
+                    ALuint buffer;
+                    alSourceUnqueueBuffers(_source, 1, &buffer);
+                    check_al_error("alSourceUnqueueBuffers");
+                    al.unlock();
+                    more = more && _music->fill(buffer, loop);
+                    al.lock();
+                    if (more) {
+                        alSourceQueueBuffers(_source, 1, &buffer);
+                        check_al_error("alSourceQueueBuffers");
+                    }
+                }
+
+                // If decoding fell behind, the source stopped when it ran out of buffers. If
+                // there's nothing left to queue, then the song is over.
+                ALint state, queued;
+                alGetSourcei(_source, AL_SOURCE_STATE, &state);
+                alGetSourcei(_source, AL_BUFFERS_QUEUED, &queued);
+                check_al_error("alGetSourcei");
+                if (state != AL_PLAYING) {
+                    if (queued == 0) {
+                        return;
+                    }
+                    alSourcePlay(_source);
+                    check_al_error("alSourcePlay");
+                }
+            } catch (std::runtime_error& e) {
+                pn::err.format("music: {0}\n", e.what());
+                return;
+            }
+        }
+    }
+
+    OpenAlSoundDriver&      _driver;
+    ALuint                  _source;
+    OpenAlMusic*            _music;  // The song being streamed, if any.
+    std::mutex              _mutex;
+    std::condition_variable _wake;
+    bool                    _streaming;
+    std::thread             _streamer;
 };
 
 void OpenAlSoundDriver::OpenAlSound::play(uint8_t volume) {
@@ -144,6 +337,23 @@ void OpenAlSoundDriver::OpenAlSound::loop(uint8_t volume) {
     _driver._active_channel->loop(*this, volume);
 }
 
+OpenAlSoundDriver::OpenAlMusic::~OpenAlMusic() {
+    if (_channel) {
+        _channel->stop_streaming();
+    }
+    std::unique_lock<std::mutex> al(al_mutex);
+    alDeleteBuffers(_buffers.size(), _buffers.data());
+    alGetError();  // discard.
+}
+
+void OpenAlSoundDriver::OpenAlMusic::play(uint8_t volume) {
+    _driver._active_channel->stream(*this, volume, false);
+}
+
+void OpenAlSoundDriver::OpenAlMusic::loop(uint8_t volume) {
+    _driver._active_channel->stream(*this, volume, true);
+}
+
 OpenAlSoundDriver::OpenAlSoundDriver() : _active_channel(NULL) {
     // TODO(sfiera): error-checking.
     _device  = alcOpenDevice(NULL);
@@ -161,19 +371,22 @@ unique_ptr<SoundChannel> OpenAlSoundDriver::open_channel() {
 }
 
 unique_ptr<Sound> OpenAlSoundDriver::open_sound(pn::string_view path) {
+    return open_decoded_sound(path, Resource::sound(path));
+}
+
+unique_ptr<Sound> OpenAlSoundDriver::open_decoded_sound(pn::string_view path, SoundData data) {
     unique_ptr<OpenAlSound> sound(new OpenAlSound(*this));
-    SoundData               s = Resource::sound(path);
-    sound->buffer(s);
+    sound->buffer(data);
     return std::move(sound);
 }
 
 unique_ptr<Sound> OpenAlSoundDriver::open_music(pn::string_view path) {
-    unique_ptr<OpenAlSound> music(new OpenAlSound(*this));
-    SoundData               s = Resource::music(path);
-    music->buffer(s);
-    return std::move(music);
+    return unique_ptr<Sound>(new OpenAlMusic(*this, Resource::music_stream(path)));
 }
 
-void OpenAlSoundDriver::set_global_volume(uint8_t volume) { alListenerf(AL_GAIN, volume / 8.0); }
+void OpenAlSoundDriver::set_global_volume(uint8_t volume) {
+    std::unique_lock<std::mutex> al(al_mutex);
+    alListenerf(AL_GAIN, volume / 8.0);
+}
 
 }  // namespace antares
@@ -189,9 +189,9 @@ class XAudio2SoundDriver::XAudio2Sound : public Sound {
             return;
         }
 
-        const size_t num_samples = s.data.size() / s.channels / sizeof(int16_t);
+        const size_t num_samples = s.samples().size() / s.channels / sizeof(int16_t);
         std::vector<BYTE> data = convert_to_stereo(
-                reinterpret_cast<const BYTE*>(s.data.data()), s.channels, num_samples);
+                reinterpret_cast<const BYTE*>(s.samples().data()), s.channels, num_samples);
 
         float  frequency_ratio =
                 static_cast<float>(s.frequency) / static_cast<float>(_driver.get_sample_rate());
@@ -326,9 +326,12 @@ unique_ptr<SoundChannel> XAudio2SoundDriver::open_channel() {
 }
 
 unique_ptr<Sound> XAudio2SoundDriver::open_sound(pn::string_view path) {
+    return open_decoded_sound(path, Resource::sound(path));
+}
+
+unique_ptr<Sound> XAudio2SoundDriver::open_decoded_sound(pn::string_view path, SoundData data) {
     unique_ptr<XAudio2Sound> sound(new XAudio2Sound(*this));
-    SoundData               s = Resource::sound(path);
-    sound->buffer(s);
+    sound->buffer(data);
     return std::move(sound);
 }
 
@@ -56,6 +56,19 @@ void EventScheduler::schedule_snapshot(int64_t at) {
     push_heap(_snapshot_times.begin(), _snapshot_times.end(), greater<wall_ticks>());
 }
 
+// Recurring snapshots are kept out of the heap, so that scheduling them takes constant space,
+// however long the run. That leaves room for only one series.
+void EventScheduler::schedule_snapshots(int64_t start, int64_t interval, int64_t end) {
+    if (interval <= 0) {
+        throw std::runtime_error("snapshot interval must be positive");
+    } else if (_recurring_interval > ticks::zero()) {
+        throw std::runtime_error("recurring snapshots are already scheduled");
+    }
+    _recurring_next     = wall_ticks(ticks(start));
+    _recurring_interval = ticks(interval);
+    _recurring_end      = wall_ticks(ticks(end));
+}
+
 void EventScheduler::schedule_event(unique_ptr<Event> event) {
     _event_heap.emplace_back(std::move(event));
     push_heap(_event_heap.begin(), _event_heap.end(), is_later);
@@ -74,6 +87,7 @@ void EventScheduler::schedule_mouse(int button, const Point& where, int64_t down
 
 void EventScheduler::loop(EventScheduler::MainLoop& loop) {
     while (!loop.done()) {
+        ++_counters.iterations;
         wall_time        at_usecs;
         const bool       has_timer = loop.top()->next_timer(at_usecs);
         const wall_ticks at_ticks  = std::chrono::time_point_cast<ticks>(at_usecs);
@@ -86,31 +100,60 @@ void EventScheduler::loop(EventScheduler::MainLoop& loop) {
             MouseReader mr(&_mouse);
             event->send(&mr);
             event->send(loop.top());
+            ++_counters.events;
         } else {
             if (!has_timer) {
                 throw std::runtime_error("Event heap empty and timer not set to fire.");
             }
             advance_tick_count(loop, max(_ticks + kMinorTick, at_ticks));
             loop.top()->fire_timer();
+            ++_counters.timers;
         }
     }
 }
 
 void EventScheduler::advance_tick_count(EventScheduler::MainLoop& loop, wall_ticks ticks) {
+    if (ticks > _ticks) {
+        _counters.ticks += (ticks - _ticks).count();
+    }
     if (loop.takes_snapshots() && have_snapshots_before(ticks)) {
         loop.draw();
         while (have_snapshots_before(ticks)) {
-            _ticks = _snapshot_times.front();
+            _ticks = next_snapshot();
             loop.snapshot(_ticks);
-            pop_heap(_snapshot_times.begin(), _snapshot_times.end(), greater<wall_ticks>());
-            _snapshot_times.pop_back();
+            pop_snapshots(_ticks);
+            ++_counters.snapshots;
         }
     }
     _ticks = ticks;
 }
 
 bool EventScheduler::have_snapshots_before(wall_ticks ticks) const {
-    return !_snapshot_times.empty() && (_snapshot_times.front() < ticks);
+    return (!_snapshot_times.empty() && (_snapshot_times.front() < ticks)) ||
+           (have_recurring_snapshot() && (_recurring_next < ticks));
+}
+
+bool EventScheduler::have_recurring_snapshot() const {
+    return (_recurring_interval > ticks::zero()) && (_recurring_next < _recurring_end);
+}
+
+wall_ticks EventScheduler::next_snapshot() const {
+    if (have_recurring_snapshot() &&
+        (_snapshot_times.empty() || (_recurring_next < _snapshot_times.front()))) {
+        return _recurring_next;
+    }
+    return _snapshot_times.front();
+}
+
+// Drops every snapshot scheduled for `at`, so that no moment is captured twice.
+void EventScheduler::pop_snapshots(wall_ticks at) {
+    while (!_snapshot_times.empty() && (_snapshot_times.front() == at)) {
+        pop_heap(_snapshot_times.begin(), _snapshot_times.end(), greater<wall_ticks>());
+        _snapshot_times.pop_back();
+    }
+    if (have_recurring_snapshot() && (_recurring_next == at)) {
+        _recurring_next += _recurring_interval;
+    }
 }
 
 bool EventScheduler::is_later(const unique_ptr<Event>& x, const unique_ptr<Event>& y) {
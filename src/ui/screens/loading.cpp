@@ -114,7 +114,8 @@ void LoadingScreen::overlay() const {
     bar.offset(off.h, off.v);
     Rects rects;
     rects.fill(bar, dark);
-    bar.right = bar.left + (bar.width() * _load_state.step / _load_state.max);
+    bar.right = bar.left +
+                (bar.width() * (_load_state.step + _load_state.fraction) / _load_state.max);
     rects.fill(bar, light);
 }
 
@@ -34,6 +34,10 @@ VideoDriver::~VideoDriver() { sys.video = NULL; }
 
 Texture::Impl::~Impl() {}
 
+std::unique_ptr<Texture::Impl> Texture::Impl::hued(Hue hue) const {
+    throw std::runtime_error(pn::format("{0}: texture has no overlay", name()).c_str());
+}
+
 TextReceiver::~TextReceiver() { sys.video->stop_editing(this); }
 
 Points::Points() { sys.video->begin_points(); }
@@ -0,0 +1,108 @@
+// Copyright (C) 1997, 1999-2001, 2008 Nathan Lamont
+// Copyright (C) 2008-2017 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include "video/frame-hashes.hpp"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <pn/output>
+
+#include "drawing/pix-map.hpp"
+#include "lang/fnv.hpp"
+
+namespace path = sfz::path;
+
+namespace antares {
+
+uint64_t frame_hash(const PixMap& pix) {
+    uint64_t h = kFnvBasis;
+    for (int32_t y = 0; y < pix.size().height; ++y) {
+        h = fnv(h, reinterpret_cast<const uint8_t*>(pix.row(y)),
+                pix.size().width * sizeof(RgbColor));
+    }
+    return h;
+}
+
+uint64_t frame_hash(pn::data_view data) { return fnv(kFnvBasis, data); }
+
+uint64_t frame_hash(pn::string_view text) { return fnv(kFnvBasis, text); }
+
+FrameHashes::FrameHashes(pn::string_view golden) : _golden(golden.copy()) {
+    if (!path::isfile(_golden)) {
+        return;
+    }
+    sfz::mapped_file file(_golden);
+    _manifest = pn::string(reinterpret_cast<const char*>(file.data().data()), file.data().size());
+    pn::string_view rest = _manifest;
+    while (!rest.empty()) {
+        auto            end  = rest.find("\n");
+        pn::string_view line = rest.substr(0, end);
+        rest                 = (end == rest.npos) ? pn::string_view{} : rest.substr(end + 1);
+
+        auto space = line.find(" ");
+        if (space == line.npos) {
+            continue;
+        }
+        pn::string hash = line.substr(space + 1).copy();
+        _manifest_hashes[line.substr(0, space)] = strtoull(hash.c_str(), nullptr, 16);
+    }
+}
+
+FrameHashes::Frame* FrameHashes::add(pn::string_view relpath) {
+    _frames.push_back(Frame{relpath.copy(), 0});
+    return &_frames.back();
+}
+
+bool FrameHashes::match(Frame* frame, uint64_t hash) {
+    frame->hash                    = hash;
+    sfz::optional<uint64_t> golden = golden_hash(frame->relpath);
+    return golden.has_value() && (*golden == hash);
+}
+
+sfz::optional<uint64_t> FrameHashes::golden_hash(pn::string_view relpath) const {
+    if (!_manifest.empty()) {
+        auto it = _manifest_hashes.find(relpath);
+        if (it == _manifest_hashes.end()) {
+            return sfz::nullopt;
+        }
+        return sfz::make_optional(it->second);
+    }
+
+    pn::string path = pn::format("{0}/{1}", _golden, relpath);
+    if (!path::isfile(path)) {
+        return sfz::nullopt;
+    }
+    sfz::mapped_file file(path);
+    if ((relpath.size() > 4) && (relpath.substr(relpath.size() - 4) == ".png")) {
+        return sfz::make_optional(frame_hash(read_png(file.data())));
+    }
+    return sfz::make_optional(frame_hash(file.data()));
+}
+
+void FrameHashes::save(pn::string_view path) const {
+    pn::output out{path, pn::text};
+    for (const Frame& frame : _frames) {
+        char hash[17];
+        snprintf(hash, sizeof(hash), "%016" PRIx64, frame.hash);
+        out.write(pn::format("{0} {1}\n", frame.relpath, hash)).check();
+    }
+}
+
+}  // namespace antares
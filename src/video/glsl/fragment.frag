@@ -39,6 +39,10 @@ uniform float     static_fraction;
 uniform vec2 unit;
 uniform vec4 outline_color;
 uniform int  seed;
+uniform sampler2DRect overlay;
+uniform sampler2D     tint_table;
+uniform int           tinted;
+uniform int           tint_hue;
 
 const int FILL_MODE           = 0;
 const int DITHER_MODE         = 1;
@@ -70,6 +74,16 @@ vec3 apple_rgb_to_srgb(vec3 apple_rgb_color) {
 
 void main() {
     vec4 sprite_color = texture2DRect(sprite, uv);
+    if (tinted != 0) {
+        // Same as tint_row(), in 8-bit steps: the tint is looked up by shade and hue, and the
+        // blend rounds down. The half-step bias keeps exact quotients from rounding below.
+        vec4 mask  = floor(texture2DRect(overlay, uv) * 255.0 + 0.5);
+        vec2 entry = vec2((mask.r + 0.5) / 256.0, (float(tint_hue) + 0.5) / 16.0);
+        vec3 over  = floor(texture2D(tint_table, entry).rgb * 255.0 + 0.5);
+        vec3 under = floor(sprite_color.rgb * 255.0 + 0.5);
+        sprite_color.rgb =
+                floor((over * mask.a + under * (255.0 - mask.a) + 0.5) / 255.0) / 255.0;
+    }
     if (color_mode == FILL_MODE) {
         frag_color = color;
     } else if (color_mode == DITHER_MODE) {
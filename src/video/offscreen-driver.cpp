@@ -20,9 +20,14 @@
 
 #include <fcntl.h>
 #include <stdlib.h>
+#include <string.h>
 #include <strings.h>
 
 #include <algorithm>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <memory>
 #include <pn/output>
 #include <sfz/sfz.hpp>
 
@@ -30,9 +35,11 @@
 #include "drawing/pix-map.hpp"
 #include "game/sys.hpp"
 #include "game/time.hpp"
+#include "lang/work-queue.hpp"
 #include "math/geometry.hpp"
 #include "ui/card.hpp"
 #include "ui/event.hpp"
+#include "video/frame-hashes.hpp"
 
 #ifdef __APPLE__
 #include <OpenGL/OpenGL.h>
@@ -62,38 +69,233 @@ namespace antares {
 
 namespace {
 
+void gl_check() {
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        throw std::runtime_error(pn::format("gl: {0}", error).c_str());
+    }
+}
+
+const int kTicksPerSecond = 60;
+
+// Writes frames to a YUV4MPEG2 stream, which encoders such as ffmpeg can read from a pipe. The
+// header is written with the first frame, which fixes the size of every frame. Frames are
+// converted to 4:4:4 Y'CbCr (BT.601, studio range) on worker threads, but written in order.
+class VideoStream {
+  public:
+    VideoStream(pn::string_view path, int ticks_per_frame) : _ticks_per_frame(ticks_per_frame) {
+        if (path != "-") {
+            _file = pn::output{path, pn::binary};
+        }
+    }
+
+    std::shared_future<void> write(ArrayPixMap pix, WorkQueue& work) {
+        if (!_size.has_value()) {
+            _size.emplace(pix.size());
+            out().format(
+                    "YUV4MPEG2 W{0} H{1} F{2}:{3} Ip A1:1 C444\n", _size->width, _size->height,
+                    kTicksPerSecond, _ticks_per_frame);
+        } else if (pix.size() != *_size) {
+            throw std::runtime_error("video frames must all be the same size");
+        }
+
+        auto task = std::make_shared<std::packaged_task<void()>>(
+                WriteFrame{std::move(pix), _last, out()});
+        _last = task->get_future().share();
+        work.post([task] { (*task)(); });
+        return _last;
+    }
+
+  private:
+    struct WriteFrame {
+        ArrayPixMap              pix;
+        std::shared_future<void> previous;
+        pn::output_view          out;
+
+        void operator()() {
+            pn::data frame = convert(pix);
+            if (previous.valid()) {
+                previous.get();
+            }
+            out.write(frame).check();
+        }
+    };
+
+    static pn::data convert(const PixMap& pix) {
+        const Size    size   = pix.size();
+        const int     area   = size.width * size.height;
+        const uint8_t tag[6] = {'F', 'R', 'A', 'M', 'E', '\n'};
+        pn::data      frame;
+        frame.resize(sizeof(tag) + (3 * area));
+        memcpy(frame.data(), tag, sizeof(tag));
+        uint8_t* y  = frame.data() + sizeof(tag);
+        uint8_t* cb = y + area;
+        uint8_t* cr = cb + area;
+        for (int32_t v : range(size.height)) {
+            const RgbColor* row = pix.row(v);
+            for (int32_t h : range(size.width)) {
+                // Offsetting by 128 << 8 keeps the sums positive, so the shifts don't round
+                // negative values differently.
+                int red = row[h].red, green = row[h].green, blue = row[h].blue;
+                *(y++)  = ((66 * red + 129 * green + 25 * blue + 128) >> 8) + 16;
+                *(cb++) = (-38 * red - 74 * green + 112 * blue + 128 + (128 << 8)) >> 8;
+                *(cr++) = (112 * red - 94 * green - 18 * blue + 128 + (128 << 8)) >> 8;
+            }
+        }
+        return frame;
+    }
+
+    pn::output_view out() { return _file.c_obj() ? pn::output_view{_file} : pn::out; }
+
+    const int                _ticks_per_frame;
+    pn::output               _file;
+    sfz::optional<Size>      _size;
+    std::shared_future<void> _last;
+};
+
+// Reads snapshots back from the framebuffer, and writes them out, without making the render
+// thread wait for either. Each snapshot is read into one of two pixel buffer objects, which isn't
+// mapped until the following snapshot has been requested; by then, the transfer has usually
+// finished. Once copied out, snapshots are encoded and written on worker threads.
 class SnapshotBuffer {
   public:
-    SnapshotBuffer() {}
+    SnapshotBuffer() {
+        glGenBuffers(2, _pbo);
+        gl_check();
+    }
+
+    ~SnapshotBuffer() { glDeleteBuffers(2, _pbo); }
+
+    // Writes the snapshot to a PNG at `path`. With `hashes`, the snapshot is recorded as `frame`
+    // instead, and only written if it doesn't match the golden one.
+    void read(
+            Rect bounds, pn::string path, FrameHashes* hashes = nullptr,
+            FrameHashes::Frame* frame = nullptr) {
+        start(bounds, Pending{0, {}, std::move(path), hashes, frame, nullptr});
+    }
+
+    // Writes the snapshot as the next frame of `video`.
+    void read(Rect bounds, VideoStream* video) {
+        start(bounds, Pending{0, {}, pn::string{}, nullptr, nullptr, video});
+    }
+
+    // Writes out every snapshot read so far, and rethrows the first failure, if any.
+    void flush() {
+        finish();
+        while (!_writing.empty()) {
+            _writing.front().get();
+            _writing.pop_front();
+        }
+    }
+
+  private:
+    static const int kMaxWriting = 16;
+
+    struct Pending {
+        GLuint              pbo;
+        Size                size;
+        pn::string          path;
+        FrameHashes*        hashes;
+        FrameHashes::Frame* frame;
+        VideoStream*        video;
+    };
+
+    struct WriteSnapshot {
+        ArrayPixMap         pix;
+        pn::string          path;
+        FrameHashes*        hashes;
+        FrameHashes::Frame* frame;
 
-    void copy(Rect bounds, ArrayPixMap& pix) {
-        _data.resize(bounds.area() * 4);
+        void operator()() {
+            if (hashes && hashes->match(frame, frame_hash(pix))) {
+                return;
+            }
+            pn::output out{path, pn::binary};
+            pix.encode(out);
+        }
+    };
+
+    void start(Rect bounds, Pending pending) {
+        // Each pixel arrives in RgbColor's byte order (alpha, red, green, blue), so rows can be
+        // copied out whole. As in OpenGlVideoDriver's uploads, the packing depends on endianness.
+#if defined(__LITTLE_ENDIAN__)
+        GLenum type = GL_UNSIGNED_INT_8_8_8_8;
+#elif defined(__BIG_ENDIAN__)
+        GLenum type = GL_UNSIGNED_INT_8_8_8_8_REV;
+#else
+#error "Couldn't determine endianness of platform"
+#endif
         Size size = bounds.size();
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, _pbo[_next]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, bounds.area() * 4, nullptr, GL_STREAM_READ);
         glReadPixels(
-                bounds.left, bounds.top, size.width, size.height, GL_BGRA, GL_UNSIGNED_BYTE,
-                _data.data());
-        uint8_t* p = _data.data();
-        for (int32_t y : range(size.height)) {
-            for (int32_t x : range(size.width)) {
-                uint8_t blue  = *(p++);
-                uint8_t green = *(p++);
-                uint8_t red   = *(p++);
-                ++p;
-                pix.set(x, size.height - y - 1, rgb(red, green, blue));
-            }
+                bounds.left, bounds.top, size.width, size.height, GL_BGRA, type, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        gl_check();
+
+        finish();
+        pending.pbo  = _pbo[_next];
+        pending.size = size;
+        _pending.emplace(std::move(pending));
+        _next = 1 - _next;
+
+        if (_writing.size() >= kMaxWriting) {
+            _writing.front().wait();
+        }
+        while (!_writing.empty() && (_writing.front().wait_for(std::chrono::seconds(0)) ==
+                                     std::future_status::ready)) {
+            _writing.front().get();
+            _writing.pop_front();
         }
     }
 
-  private:
-    vector<uint8_t> _data;
-};
+    // Copies the pending snapshot out of its buffer, flipping it right side up, and queues it to
+    // be written.
+    void finish() {
+        if (!_pending.has_value()) {
+            return;
+        }
+        Pending pending = std::move(*_pending);
+        _pending        = sfz::nullopt;
+
+        const int32_t width  = pending.size.width;
+        const int32_t height = pending.size.height;
+        ArrayPixMap   pix(pending.size);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pending.pbo);
+        auto data = reinterpret_cast<const RgbColor*>(
+                glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+        if (!data) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            gl_check();
+            throw std::runtime_error("gl: couldn't map snapshot buffer");
+        }
+        for (int32_t y : range(height)) {
+            RgbColor* row = pix.mutable_row(height - y - 1);
+            memcpy(row, data + (y * width), width * sizeof(RgbColor));
+            for (int32_t x : range(width)) {
+                row[x].alpha = 0xff;
+            }
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        gl_check();
 
-void gl_check() {
-    GLenum error = glGetError();
-    if (error != GL_NO_ERROR) {
-        throw std::runtime_error(pn::format("gl: {0}", error).c_str());
+        if (pending.video) {
+            _writing.push_back(pending.video->write(std::move(pix), _work));
+            return;
+        }
+        auto task = std::make_shared<std::packaged_task<void()>>(WriteSnapshot{
+                std::move(pix), std::move(pending.path), pending.hashes, pending.frame});
+        _writing.push_back(task->get_future().share());
+        _work.post([task] { (*task)(); });
     }
-}
+
+    GLuint                               _pbo[2];
+    int                                  _next = 0;
+    sfz::optional<Pending>               _pending;
+    std::deque<std::shared_future<void>> _writing;
+    WorkQueue                            _work;  // Last, so that its jobs finish first.
+};
 
 struct Framebuffer {
     GLuint id;
@@ -131,33 +333,43 @@ class OffscreenVideoDriver::MainLoop : public EventScheduler::MainLoop {
         if (output_dir.has_value()) {
             _output_dir.emplace(output_dir->copy());
         }
+        if (driver._video_out.has_value()) {
+            _video.reset(new VideoStream(*driver._video_out, driver._ticks_per_frame));
+        }
+        if (output_dir.has_value() && driver._hash_frames.has_value()) {
+            _hashes.reset(new FrameHashes(*driver._hash_frames));
+        }
     }
 
-    bool takes_snapshots() { return _output_dir.has_value(); }
+    bool takes_snapshots() { return _output_dir.has_value() || _video; }
 
     void snapshot(wall_ticks ticks) {
+        if (_video) {
+            _buffer.read(viewport_rect(_driver._capture_rect), _video.get());
+            return;
+        }
         snapshot_to(
                 _driver._capture_rect,
                 pn::format("screens/{0}.png", dec(ticks.time_since_epoch().count(), 6)));
     }
 
     void snapshot_to(Rect bounds, pn::string_view relpath) {
-        if (!takes_snapshots()) {
+        if (!_output_dir.has_value()) {
             return;
         }
-        bounds = Rect{
-                bounds.left * _driver._scale,
-                bounds.top * _driver._scale,
-                bounds.right * _driver._scale,
-                bounds.bottom * _driver._scale,
-        };
-        bounds.offset(0, _driver.viewport_size().height - bounds.height() - bounds.top);
-        ArrayPixMap pix(bounds.size());
-        _buffer.copy(bounds, pix);
         pn::string path = pn::format("{0}/{1}", *_output_dir, relpath);
         sfz::makedirs(path::dirname(path), 0755);
-        pn::output out{path, pn::binary};
-        pix.encode(out);
+        _buffer.read(
+                viewport_rect(bounds), std::move(path), _hashes.get(),
+                _hashes ? _hashes->add(relpath) : nullptr);
+    }
+
+    // Snapshots are written asynchronously; this waits for them to be written.
+    void flush() {
+        _buffer.flush();
+        if (_hashes) {
+            _hashes->save(pn::format("{0}/frames.hash", *_output_dir));
+        }
     }
 
     void  draw() { _loop.draw(); }
@@ -165,11 +377,25 @@ class OffscreenVideoDriver::MainLoop : public EventScheduler::MainLoop {
     Card* top() const { return _loop.top(); }
 
   private:
-    const OffscreenVideoDriver& _driver;
-    Offscreen                   _offscreen;
-    Framebuffer                 _fb;
-    Renderbuffer                _rb;
-    SnapshotBuffer              _buffer;
+    // Scales `bounds` from screen to viewport coordinates, and flips it to GL's bottom-up rows.
+    Rect viewport_rect(Rect bounds) const {
+        bounds = Rect{
+                bounds.left * _driver._scale,
+                bounds.top * _driver._scale,
+                bounds.right * _driver._scale,
+                bounds.bottom * _driver._scale,
+        };
+        bounds.offset(0, _driver.viewport_size().height - bounds.height() - bounds.top);
+        return bounds;
+    }
+
+    const OffscreenVideoDriver&  _driver;
+    Offscreen                    _offscreen;
+    Framebuffer                  _fb;
+    Renderbuffer                 _rb;
+    std::unique_ptr<VideoStream> _video;   // Before _buffer, which writes to it.
+    std::unique_ptr<FrameHashes> _hashes;  // Likewise.
+    SnapshotBuffer               _buffer;
     struct Setup {
         Setup(OffscreenVideoDriver::MainLoop& loop) {
             glBindFramebuffer(GL_FRAMEBUFFER, loop._fb.id);
@@ -181,9 +407,9 @@ class OffscreenVideoDriver::MainLoop : public EventScheduler::MainLoop {
                     GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, loop._rb.id);
         }
     };
-    Setup                       _setup;
-    sfz::optional<pn::string>   _output_dir;
-    OpenGlVideoDriver::MainLoop _loop;
+    Setup                        _setup;
+    sfz::optional<pn::string>    _output_dir;
+    OpenGlVideoDriver::MainLoop  _loop;
 };
 
 OffscreenVideoDriver::OffscreenVideoDriver(
@@ -205,10 +431,16 @@ bool OffscreenVideoDriver::start_editing(TextReceiver* text) { return false; }
 
 void OffscreenVideoDriver::stop_editing(TextReceiver* text) {}
 
+void OffscreenVideoDriver::set_video_out(pn::string_view path, int ticks_per_frame) {
+    _video_out.emplace(path.copy());
+    _ticks_per_frame = ticks_per_frame;
+}
+
 void OffscreenVideoDriver::loop(Card* initial, EventScheduler& scheduler) {
     _scheduler = &scheduler;
     MainLoop loop(*this, _output_dir, initial);
     _scheduler->loop(loop);
+    loop.flush();
     _scheduler = nullptr;
 }
 
@@ -237,6 +469,7 @@ void OffscreenVideoDriver::capture(vector<pair<unique_ptr<Card>, pn::string>>& p
         loop.snapshot_to(_capture_rect, p.second);
         loop.top()->stack()->pop(loop.top());
     }
+    loop.flush();
 }
 
 }  // namespace antares
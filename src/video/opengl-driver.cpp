@@ -21,6 +21,7 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <memory>
 #include <pn/output>
 
 #include "drawing/color.hpp"
@@ -194,40 +195,36 @@ void gl_log(GLint object) {
 }
 
 class OpenGlTextureImpl : public Texture::Impl {
+    struct Texture;  // Shared between hued copies.
+
   public:
     OpenGlTextureImpl(
             pn::string_view name, const PixMap& image, int scale,
             const OpenGlVideoDriver::Uniforms& uniforms, GLuint vbuf[3])
             : _name(name.copy()),
+              _texture(upload(image)),
               _size(image.size()),
               _scale(scale),
               _uniforms(uniforms),
-              _vbuf(vbuf) {
-        glBindTexture(GL_TEXTURE_RECTANGLE, _texture.id);
-        glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-#if defined(__LITTLE_ENDIAN__)
-        GLenum type = GL_UNSIGNED_INT_8_8_8_8;
-#elif defined(__BIG_ENDIAN__)
-        GLenum type = GL_UNSIGNED_INT_8_8_8_8_REV;
-#else
-#error "Couldn't determine endianness of platform"
-#endif
+              _vbuf(vbuf) {}
 
-        // Add a 1-pixel clear border.  Color mode 5 (outline) won't work unless we do this.
-        Size size = image.size();
-        size.width += 2;
-        size.height += 2;
-        ArrayPixMap copy(size);
-        copy.fill(RgbColor::clear());
-        copy.view(Rect(1, 1, size.width - 1, size.height - 1)).copy(image);
-        glTexImage2D(
-                GL_TEXTURE_RECTANGLE, 0, GL_RGBA8, size.width, size.height, 0, GL_BGRA, type,
-                copy.bytes());
+    OpenGlTextureImpl(
+            pn::string_view name, const PixMap& image, const PixMap& overlay, int scale,
+            const OpenGlVideoDriver::Uniforms& uniforms, GLuint vbuf[3])
+            : OpenGlTextureImpl(name, image, scale, uniforms, vbuf) {
+        _overlay = upload(overlay);
     }
 
+    OpenGlTextureImpl(const OpenGlTextureImpl& other, Hue hue)
+            : _name(other._name.copy()),
+              _texture(other._texture),
+              _overlay(other._overlay),
+              _hue(hue),
+              _size(other._size),
+              _scale(other._scale),
+              _uniforms(other._uniforms),
+              _vbuf(other._vbuf) {}
+
     virtual pn::string_view name() const { return _name; }
 
     virtual void draw(const Rect& draw_rect) const {
@@ -265,7 +262,56 @@ class OpenGlTextureImpl : public Texture::Impl {
 
     virtual const Size& size() const { return _size; }
 
+    virtual unique_ptr<antares::Texture::Impl> hued(Hue hue) const {
+        if (!_overlay) {
+            return antares::Texture::Impl::hued(hue);
+        }
+        return unique_ptr<antares::Texture::Impl>(new OpenGlTextureImpl(*this, hue));
+    }
+
   private:
+    static std::shared_ptr<const Texture> upload(const PixMap& image) {
+        std::shared_ptr<Texture> texture = std::make_shared<Texture>();
+        glBindTexture(GL_TEXTURE_RECTANGLE, texture->id);
+        glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+#if defined(__LITTLE_ENDIAN__)
+        GLenum type = GL_UNSIGNED_INT_8_8_8_8;
+#elif defined(__BIG_ENDIAN__)
+        GLenum type = GL_UNSIGNED_INT_8_8_8_8_REV;
+#else
+#error "Couldn't determine endianness of platform"
+#endif
+
+        // Add a 1-pixel clear border.  Color mode 5 (outline) won't work unless we do this.
+        Size size = image.size();
+        size.width += 2;
+        size.height += 2;
+        ArrayPixMap copy(size);
+        copy.fill(RgbColor::clear());
+        copy.view(Rect(1, 1, size.width - 1, size.height - 1)).copy(image);
+        glTexImage2D(
+                GL_TEXTURE_RECTANGLE, 0, GL_RGBA8, size.width, size.height, 0, GL_BGRA, type,
+                copy.bytes());
+        return texture;
+    }
+
+    // Binds the textures, and selects the overlay's row of the tint table, if any.
+    void bind() const {
+        if (_overlay && (_hue != Hue::GRAY)) {
+            _uniforms.tinted.set(1);
+            _uniforms.tint_hue.set(static_cast<int>(_hue));
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_RECTANGLE, _overlay->id);
+        } else {
+            _uniforms.tinted.set(0);
+        }
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_RECTANGLE, _texture->id);
+    }
+
     virtual void draw_internal(const Rect& draw_rect, const RgbColor& tint) const {
         glEnableVertexAttribArray(0);
         glEnableVertexAttribArray(1);
@@ -299,8 +345,7 @@ class OpenGlTextureImpl : public Texture::Impl {
         glBufferData(GL_ARRAY_BUFFER, sizeof(tex_coords), tex_coords, GL_STREAM_DRAW);
         glVertexAttribPointer(2, 2, GL_SHORT, GL_FALSE, 0, nullptr);
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_RECTANGLE, _texture.id);
+        bind();
         glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 
         glDisableVertexAttribArray(2);
@@ -310,8 +355,7 @@ class OpenGlTextureImpl : public Texture::Impl {
 
     virtual void begin_quads() const {
         _uniforms.color_mode.set(TINT_SPRITE_MODE);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_RECTANGLE, _texture.id);
+        bind();
     }
 
     virtual void end_quads() const {}
@@ -353,7 +397,7 @@ class OpenGlTextureImpl : public Texture::Impl {
         glVertexAttribPointer(2, 2, GL_SHORT, GL_FALSE, 0, nullptr);
 
         glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_RECTANGLE, _texture.id);
+        glBindTexture(GL_TEXTURE_RECTANGLE, _texture->id);
         glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 
         glDisableVertexAttribArray(2);
@@ -371,7 +415,9 @@ class OpenGlTextureImpl : public Texture::Impl {
     };
 
     const pn::string                   _name;
-    Texture                            _texture;
+    std::shared_ptr<const Texture>     _texture;
+    std::shared_ptr<const Texture>     _overlay;
+    Hue                                _hue = Hue::GRAY;
     Size                               _size;
     int                                _scale;
     const OpenGlVideoDriver::Uniforms& _uniforms;
@@ -389,6 +435,12 @@ Texture OpenGlVideoDriver::texture(pn::string_view name, const PixMap& content,
             new OpenGlTextureImpl(name, content, scale, _uniforms, _vbuf));
 }
 
+Texture OpenGlVideoDriver::texture(
+        pn::string_view name, const PixMap& content, const PixMap& overlay, int scale) {
+    return unique_ptr<Texture::Impl>(
+            new OpenGlTextureImpl(name, content, overlay, scale, _uniforms, _vbuf));
+}
+
 void OpenGlVideoDriver::begin_rects() { _uniforms.color_mode.set(FILL_MODE); }
 
 void OpenGlVideoDriver::batch_rect(const Rect& rect, const RgbColor& color) {
@@ -629,6 +681,10 @@ OpenGlVideoDriver::MainLoop::Setup::Setup(OpenGlVideoDriver& driver) {
     driver._uniforms.unit.load(program);
     driver._uniforms.outline_color.load(program);
     driver._uniforms.seed.load(program);
+    driver._uniforms.overlay.load(program);
+    driver._uniforms.tint_table.load(program);
+    driver._uniforms.tinted.load(program);
+    driver._uniforms.tint_hue.load(program);
     glUseProgram(program);
 
     GLuint static_texture;
@@ -648,8 +704,35 @@ OpenGlVideoDriver::MainLoop::Setup::Setup(OpenGlVideoDriver& driver) {
     glTexImage2D(
             GL_TEXTURE_2D, 0, GL_RG, size, size, 0, GL_RG, GL_UNSIGNED_BYTE, static_data.get());
 
+    // RgbColor::tint() of each shade (column) of each hue (row), so that the shader tints an
+    // overlay with exactly the colors that precompositing would.
+    GLuint tint_texture;
+    glGenTextures(1, &tint_texture);
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, tint_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    const int             hues = 16;
+    unique_ptr<uint8_t[]> tint_data(new uint8_t[hues * 256 * 4]);
+    p = tint_data.get();
+    for (int hue = 0; hue < hues; ++hue) {
+        for (int shade = 0; shade < 256; ++shade) {
+            RgbColor c = RgbColor::tint(static_cast<Hue>(hue), shade);
+            *(p++)     = c.red;
+            *(p++)     = c.green;
+            *(p++)     = c.blue;
+            *(p++)     = c.alpha;
+        }
+    }
+    glTexImage2D(
+            GL_TEXTURE_2D, 0, GL_RGBA8, 256, hues, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+            tint_data.get());
+
     driver._uniforms.sprite.set(0);
     driver._uniforms.static_image.set(1);
+    driver._uniforms.overlay.set(2);
+    driver._uniforms.tint_table.set(3);
+    driver._uniforms.tinted.set(0);
 }
 
 OpenGlVideoDriver::MainLoop::MainLoop(OpenGlVideoDriver& driver, Card* initial)
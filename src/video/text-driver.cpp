@@ -20,7 +20,9 @@
 
 #include <fcntl.h>
 #include <stdlib.h>
+#include <zlib.h>
 #include <algorithm>
+#include <memory>
 #include <pn/output>
 #include <sfz/sfz.hpp>
 
@@ -32,6 +34,7 @@
 #include "math/geometry.hpp"
 #include "ui/card.hpp"
 #include "ui/event.hpp"
+#include "video/frame-hashes.hpp"
 
 using sfz::dec;
 using std::make_pair;
@@ -54,6 +57,18 @@ pn::string hex(RgbColor color) {
     return s;
 }
 
+void write_gzip(pn::string_view path, pn::string_view data) {
+    gzFile file = gzopen(path.copy().c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error(pn::format("{0}: couldn't open", path).c_str());
+    }
+    int written = data.empty() ? 0 : gzwrite(file, data.data(), data.size());
+    int closed  = gzclose(file);
+    if ((written != data.size()) || (closed != Z_OK)) {
+        throw std::runtime_error(pn::format("{0}: couldn't write", path).c_str());
+    }
+}
+
 }  // namespace
 
 class TextVideoDriver::TextureImpl : public Texture::Impl {
@@ -117,6 +132,11 @@ class TextVideoDriver::TextureImpl : public Texture::Impl {
 
     virtual const Size& size() const { return _size; }
 
+    // Tinting doesn't change what is logged, so a hued texture is just a copy.
+    virtual std::unique_ptr<Texture::Impl> hued(Hue hue) const {
+        return std::unique_ptr<Texture::Impl>(new TextureImpl(_name, _driver, _size));
+    }
+
   private:
     pn::string       _name;
     TextVideoDriver& _driver;
@@ -129,6 +149,9 @@ class TextVideoDriver::MainLoop : public EventScheduler::MainLoop {
             : _driver(driver), _stack(initial) {
         if (output_dir.has_value()) {
             _output_dir.emplace(output_dir->copy());
+            if (driver._hash_frames.has_value()) {
+                _hashes.reset(new FrameHashes(*driver._hash_frames));
+            }
         }
     }
 
@@ -139,10 +162,23 @@ class TextVideoDriver::MainLoop : public EventScheduler::MainLoop {
     }
 
     void snapshot_to(pn::string_view relpath) {
+        if (_hashes && _hashes->match(_hashes->add(relpath), frame_hash(_driver._log))) {
+            return;
+        }
         pn::string path = pn::format("{0}/{1}", *_output_dir, relpath);
         sfz::makedirs(path::dirname(path), 0755);
-        pn::output out{path, pn::binary};
-        out.write(_driver._log);
+        if (_driver._gzip) {
+            write_gzip(pn::format("{0}.gz", path), _driver._log);
+        } else {
+            pn::output out{path, pn::binary};
+            out.write(_driver._log);
+        }
+    }
+
+    void flush() {
+        if (_hashes) {
+            _hashes->save(pn::format("{0}/frames.hash", *_output_dir));
+        }
     }
 
     void draw() {
@@ -154,9 +190,10 @@ class TextVideoDriver::MainLoop : public EventScheduler::MainLoop {
     Card* top() const { return _stack.top(); }
 
   private:
-    TextVideoDriver&          _driver;
-    sfz::optional<pn::string> _output_dir;
-    CardStack                 _stack;
+    TextVideoDriver&             _driver;
+    sfz::optional<pn::string>    _output_dir;
+    std::unique_ptr<FrameHashes> _hashes;
+    CardStack                    _stack;
 };
 
 TextVideoDriver::TextVideoDriver(Size screen_size, const sfz::optional<pn::string>& output_dir)
@@ -177,6 +214,11 @@ Texture TextVideoDriver::texture(pn::string_view name, const PixMap& content, in
     return std::unique_ptr<Texture::Impl>(new TextureImpl(name, *this, content.size()));
 }
 
+Texture TextVideoDriver::texture(
+        pn::string_view name, const PixMap& content, const PixMap& overlay, int scale) {
+    return texture(name, content, scale);
+}
+
 void TextVideoDriver::batch_rect(const Rect& rect, const RgbColor& color) {
     if (!world().intersects(rect)) {
         return;
@@ -221,6 +263,7 @@ void TextVideoDriver::loop(Card* initial, EventScheduler& scheduler) {
     _scheduler = &scheduler;
     MainLoop loop(*this, _output_dir, initial);
     _scheduler->loop(loop);
+    loop.flush();
     _scheduler = nullptr;
 }
 
@@ -249,6 +292,7 @@ void TextVideoDriver::capture(vector<pair<unique_ptr<Card>, pn::string>>& pix) {
         loop.snapshot_to(p.second);
         loop.top()->stack()->pop(loop.top());
     }
+    loop.flush();
 }
 
 void TextVideoDriver::add_arg(pn::string_view arg, std::vector<std::pair<size_t, size_t>>& args) {